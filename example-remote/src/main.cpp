@@ -0,0 +1,20 @@
+#include "ofMain.h"
+#include "ofApp.h"
+
+// Run once as is, then a second time with --viewer to control the first one from the second window
+int main(int argc, char* argv[])
+{
+    bool isViewer = argc > 1 && std::string(argv[1]) == "--viewer";
+
+#if defined(TARGET_OPENGLES)
+  ofGLESWindowSettings settings;
+  settings.setSize(1280, 720);
+  settings.setGLESVersion(2);
+  ofCreateWindow(settings);
+#else
+  ofSetupOpenGL(1280, 720, OF_WINDOW);
+#endif
+
+ofRunApp( new ofApp(isViewer));
+
+}
@@ -0,0 +1,72 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+ofApp::ofApp(bool isViewer)
+: isViewer(isViewer)
+{
+}
+
+//--------------------------------------------------------------
+void ofApp::setup()
+{
+    if(isViewer)
+    {
+        ofSetWindowTitle("ofxImGui remote viewer");
+
+        //the viewer only draws what the other process sends
+        gui.setup(nullptr, false);
+        viewer.setup(gui, "127.0.0.1", ofxImGui::kDefaultRemotePort);
+    }
+    else
+    {
+        ofSetWindowTitle("ofxImGui remote server");
+
+        gui.setup();
+        gui.setRemoteStreaming(true, ofxImGui::kDefaultRemotePort);
+    }
+
+    show_test_window = true;
+    floatValue = 0.0f;
+}
+
+//--------------------------------------------------------------
+void ofApp::update()
+{
+    if(isViewer)
+    {
+        viewer.update();
+    }
+}
+
+//--------------------------------------------------------------
+void ofApp::draw()
+{
+    ofBackground(114, 144, 154);
+
+    if(isViewer)
+    {
+        viewer.draw();
+        if(!viewer.isConnected())
+        {
+            ofDrawBitmapStringHighlight("Waiting for the server", 20, 30);
+        }
+        return;
+    }
+
+    gui.begin();
+
+    ImGui::Text("Remote streaming %s", gui.isRemoteStreaming() ? "on" : "off");
+    ImGui::SliderFloat("Float", &floatValue, 0.0f, 1.0f);
+    if(ImGui::Button("Demo Window"))
+    {
+        show_test_window = !show_test_window;
+    }
+    ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+    if(show_test_window)
+    {
+        ImGui::ShowDemoWindow(&show_test_window);
+    }
+
+    gui.end();
+}
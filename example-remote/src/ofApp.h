@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxImGui.h"
+
+class ofApp : public ofBaseApp{
+public:
+    ofApp(bool isViewer);
+
+    void setup();
+    void update();
+    void draw();
+
+    bool isViewer;
+
+    ofxImGui::Gui gui;
+    ofxImGui::RemoteViewer viewer;
+
+    bool show_test_window;
+    float floatValue;
+};
@@ -0,0 +1,64 @@
+#!/bin/sh
+# Compiles imgui.vert and imgui.frag to SPIR-V, validates it and writes src/EngineVkShaders.h.
+# Needs glslangValidator and spirv-val from the Vulkan SDK, or the glslang-tools and
+# spirv-tools packages, on the PATH. Run it after changing either shader.
+# With --check the header is only compared, the script fails when it is not what the shaders give.
+set -e
+
+cd "$(dirname "$0")"
+header=../src/EngineVkShaders.h
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+output=$header
+if [ "$1" = "--check" ]
+then
+	output=$tmp/EngineVkShaders.h
+fi
+
+# Words of a SPIR-V binary as a C array, 8 per line
+words()
+{
+	echo "	const uint32_t $2[] ="
+	echo "	{"
+	od -An -v -tx4 -w32 "$1" | sed -e 's/^ */		/' -e 's/\([0-9a-f]\{8\}\)/0x\1,/g' -e 's/ *$//'
+	echo "	};"
+}
+
+for stage in vert frag
+do
+	glslangValidator -V --target-env vulkan1.0 -o "$tmp/imgui.$stage.spv" "imgui.$stage"
+	spirv-val --target-env vulkan1.0 "$tmp/imgui.$stage.spv"
+done
+
+{
+	echo "#pragma once"
+	echo ""
+	echo "#include \"ofConstants.h\""
+	echo "#if defined(OF_TARGET_API_VULKAN)"
+	echo ""
+	echo "#include <cstdint>"
+	echo ""
+	echo "// SPIR-V of shaders/imgui.vert and shaders/imgui.frag, so no shader files have to be shipped"
+	echo "// or compiled at startup. Regenerate it with shaders/generate_spirv.sh instead of editing it."
+	echo ""
+	echo "namespace ofxImGui"
+	echo "{"
+	words "$tmp/imgui.vert.spv" kImGuiVertSpv
+	echo ""
+	words "$tmp/imgui.frag.spv" kImGuiFragSpv
+	echo "}"
+	echo ""
+	echo "#endif // OF_TARGET_API_VULKAN"
+} > "$output"
+
+if [ "$output" != "$header" ]
+then
+	if ! cmp -s "$output" "$header"
+	then
+		echo "$header is not generated from the current shaders, run $0"
+		exit 1
+	fi
+	echo "$header is up to date"
+	exit 0
+fi
+echo "Wrote $header"
@@ -0,0 +1,13 @@
+#version 450 core
+
+layout (set = 0, binding = 1) uniform sampler2D tex_unit_0;
+
+layout (location = 0) in vec4 inColor;
+layout (location = 1) in vec2 inTexCoord;
+
+layout (location = 0) out vec4 outFragColor;
+
+void main()
+{
+	outFragColor = inColor * texture(tex_unit_0, inTexCoord);
+}
@@ -0,0 +1,26 @@
+#version 450 core
+
+// EngineVk looks the uniform block, inputs and outputs up by name, keep them when changing this
+layout (set = 0, binding = 0) uniform DefaultMatrices
+{
+	mat4 modelViewProjectionMatrix;
+};
+
+layout (location = 0) in vec2 inPos;
+layout (location = 1) in vec2 inTexCoord;
+layout (location = 2) in vec4 inColor;
+
+layout (location = 0) out vec4 outColor;
+layout (location = 1) out vec2 outTexCoord;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+void main()
+{
+	outTexCoord = inTexCoord;
+	outColor = inColor;
+	gl_Position = modelViewProjectionMatrix * vec4(inPos.x, inPos.y, 0.0, 1.0);
+}
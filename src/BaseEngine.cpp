@@ -2,8 +2,13 @@
 
 #include "ofAppBaseWindow.h"
 #include "ofAppRunner.h"
+#include "ofUtils.h"
 #include "imgui.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 namespace ofxImGui
 {
 	int BaseEngine::g_ShaderHandle = 0;
@@ -20,6 +25,74 @@ namespace ofxImGui
 	unsigned int BaseEngine::g_VaoHandle = 0;
 	unsigned int BaseEngine::g_ElementsHandle = 0;
 
+	RenderStats BaseEngine::g_Stats;
+
+	bool BaseEngine::g_UseMergedUpload = false;
+	thread_local bool BaseEngine::g_PremultipliedAlphaTarget = false;
+	ImVector<ImDrawVert> BaseEngine::g_VtxStaging;
+	ImVector<ImDrawIdx> BaseEngine::g_IdxStaging;
+	bool BaseEngine::g_UseCompactVertices = false;
+	ImVector<CompactDrawVert> BaseEngine::g_CompactVtxStaging;
+	std::atomic<bool> BaseEngine::g_UseTiming(false);
+	std::atomic<bool> BaseEngine::g_ClearDrawTimings(false);
+
+	//--------------------------------------------------------------
+	void TimingHistory::add(float milliseconds)
+	{
+		if (count == kNumSamples)
+		{
+			sum -= samples[next];
+		}
+		else
+		{
+			count++;
+		}
+		samples[next] = milliseconds;
+		sum += milliseconds;
+		next = (next + 1) % kNumSamples;
+		if (next == 0)
+		{
+			// Sum again once per round, so rounding errors do not pile up
+			sum = std::accumulate(samples, samples + count, 0.0f);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void TimingHistory::clear()
+	{
+		count = 0;
+		next = 0;
+		sum = 0.0f;
+	}
+
+	//--------------------------------------------------------------
+	float TimingHistory::getLast() const
+	{
+		return count > 0 ? samples[(next + kNumSamples - 1) % kNumSamples] : 0.0f;
+	}
+
+	//--------------------------------------------------------------
+	float TimingHistory::getAverage() const
+	{
+		return count > 0 ? sum / count : 0.0f;
+	}
+
+	//--------------------------------------------------------------
+	float TimingHistory::getPercentile(float percentile) const
+	{
+		if (count == 0)
+		{
+			return 0.0f;
+		}
+		// Nearest rank, on a copy since the ring keeps the samples in arrival order
+		float sorted[kNumSamples];
+		std::copy(samples, samples + count, sorted);
+		int rank = (int)std::ceil(std::min(std::max(percentile, 0.0f), 100.0f) / 100.0f * count) - 1;
+		rank = std::max(rank, 0);
+		std::nth_element(sorted, sorted + rank, sorted + count);
+		return sorted[rank];
+	}
+
 	//--------------------------------------------------------------
 	void BaseEngine::onKeyPressed(ofKeyEventArgs& event)
 	{
@@ -41,6 +114,7 @@ namespace ofxImGui
 		if (event.button >= 0 && event.button < 5)
 		{
 			mousePressed[event.button] = true;
+			mouseLatched[event.button] = true;
 		}
 	}
 
@@ -57,8 +131,8 @@ namespace ofxImGui
 	void BaseEngine::onMouseScrolled(ofMouseEventArgs& event)
 	{
 		ImGuiIO& io = ImGui::GetIO();
-		io.MouseWheelH = event.scrollX;
-		io.MouseWheel = event.scrollY;
+		io.MouseWheelH += event.scrollX;
+		io.MouseWheel += event.scrollY;
 	}
 
 	//--------------------------------------------------------------
@@ -68,6 +142,78 @@ namespace ofxImGui
 		io.DisplaySize = ImVec2((float)window.width, (float)window.height);
 	}
 
+	//--------------------------------------------------------------
+	void BaseEngine::addInputTracking()
+	{
+		ofAddListener(ofEvents().mouseMoved, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().mouseDragged, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().mousePressed, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().mouseReleased, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().mouseScrolled, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().mouseEntered, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().mouseExited, this, &BaseEngine::onMouseInput);
+		ofAddListener(ofEvents().keyPressed, this, &BaseEngine::onKeyInput);
+		ofAddListener(ofEvents().keyReleased, this, &BaseEngine::onKeyInput);
+		ofAddListener(ofEvents().windowResized, this, &BaseEngine::onWindowInput);
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::removeInputTracking()
+	{
+		ofRemoveListener(ofEvents().mouseMoved, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().mouseDragged, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().mousePressed, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().mouseReleased, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().mouseScrolled, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().mouseEntered, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().mouseExited, this, &BaseEngine::onMouseInput);
+		ofRemoveListener(ofEvents().keyPressed, this, &BaseEngine::onKeyInput);
+		ofRemoveListener(ofEvents().keyReleased, this, &BaseEngine::onKeyInput);
+		ofRemoveListener(ofEvents().windowResized, this, &BaseEngine::onWindowInput);
+	}
+
+	//--------------------------------------------------------------
+	unsigned int BaseEngine::takeInputEvents()
+	{
+		unsigned int count = pendingInputEvents;
+		pendingInputEvents = 0;
+		return count;
+	}
+
+	//--------------------------------------------------------------
+	const std::vector<SetupTiming>& BaseEngine::getSetupTimings() const
+	{
+		return setupTimings;
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::addSetupTiming(const std::string& phase, uint64_t startMicros)
+	{
+		setupTimings.push_back({ phase, (ofGetElapsedTimeMicros() - startMicros) / 1000.0f });
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::onMouseInput(ofMouseEventArgs& event)
+	{
+		pendingInputEvents++;
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::onKeyInput(ofKeyEventArgs& event)
+	{
+		pendingInputEvents++;
+		if (event.type == ofKeyEventArgs::Pressed)
+		{
+			latchedKeys.push_back(event.keycode);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::onWindowInput(ofResizeEventArgs& window)
+	{
+		pendingInputEvents++;
+	}
+
 	//--------------------------------------------------------------
 	const char* BaseEngine::getClipboardString(void * userData)
 	{
@@ -80,6 +226,157 @@ namespace ofxImGui
 		ofGetWindowPtr()->setClipboardString(text);
 	}
 
+	//--------------------------------------------------------------
+	void BaseEngine::setMergedUpload(bool enabled)
+	{
+		g_UseMergedUpload = enabled;
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::mergeDrawData(ImDrawData * draw_data, bool rebase_indices)
+	{
+		// Staging buffers keep their capacity, so this does not allocate once the GUI has settled
+		g_VtxStaging.resize(draw_data->TotalVtxCount);
+
+		ImDrawVert* vtx_dst = g_VtxStaging.Data;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+			vtx_dst += cmd_list->VtxBuffer.Size;
+		}
+		mergeIndices(draw_data, rebase_indices);
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::addDrawTiming(uint64_t startMicros)
+	{
+		if (g_UseTiming)
+		{
+			if (g_ClearDrawTimings.exchange(false))
+			{
+				g_Stats.timings.draw.clear();
+				g_Stats.timings.gpuDraw.clear();
+			}
+			uint64_t micros = ofGetElapsedTimeMicros() - startMicros;
+			g_Stats.timings.draw.add(micros / 1000.0f);
+			g_Stats.timings.drawMicros += micros;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::setTiming(bool enabled)
+	{
+		if (enabled && !g_UseTiming)
+		{
+			// The draw may be running on another thread
+			g_Stats.timings.newFrame.clear();
+			g_Stats.timings.render.clear();
+			g_ClearDrawTimings = true;
+		}
+		g_UseTiming = enabled;
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::setCompactVertices(bool enabled)
+	{
+		g_UseCompactVertices = enabled;
+	}
+
+	//--------------------------------------------------------------
+	bool BaseEngine::mergeCompactDrawData(ImDrawData * draw_data, bool rebase_indices)
+	{
+		const float pos_scale = (float)CompactDrawVert::kPosScale;
+		const float pos_min = -32768.0f / pos_scale;
+		const float pos_max = 32767.0f / pos_scale;
+
+		g_CompactVtxStaging.resize(draw_data->TotalVtxCount);
+
+		CompactDrawVert* vtx_dst = g_CompactVtxStaging.Data;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			for (const ImDrawVert& v : cmd_list->VtxBuffer)
+			{
+				if (!(v.pos.x >= pos_min && v.pos.x <= pos_max && v.pos.y >= pos_min && v.pos.y <= pos_max
+					&& v.uv.x >= 0.0f && v.uv.x <= 1.0f && v.uv.y >= 0.0f && v.uv.y <= 1.0f))
+				{
+					return false;
+				}
+				// Rounded to the nearest step, the + 0.5f bias keeps floor() from rounding towards zero
+				vtx_dst->pos[0] = (int16_t)floorf(v.pos.x * pos_scale + 0.5f);
+				vtx_dst->pos[1] = (int16_t)floorf(v.pos.y * pos_scale + 0.5f);
+				vtx_dst->uv[0] = (uint16_t)(v.uv.x * 65535.0f + 0.5f);
+				vtx_dst->uv[1] = (uint16_t)(v.uv.y * 65535.0f + 0.5f);
+				vtx_dst->col = v.col;
+				vtx_dst++;
+			}
+		}
+		mergeIndices(draw_data, rebase_indices);
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void BaseEngine::mergeIndices(ImDrawData * draw_data, bool rebase_indices)
+	{
+		g_IdxStaging.resize(draw_data->TotalIdxCount);
+
+		ImDrawIdx* idx_dst = g_IdxStaging.Data;
+		int vtx_base = 0;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			if (rebase_indices)
+			{
+				// Each command may address its own vertex segment of the list
+				const ImDrawIdx* idx_src = cmd_list->IdxBuffer.Data;
+				ImDrawIdx* cmd_idx_dst = idx_dst;
+				for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+				{
+					ImDrawIdx cmd_base = (ImDrawIdx)(vtx_base + cmd.VtxOffset);
+					for (unsigned int i = 0; i < cmd.ElemCount; i++)
+					{
+						cmd_idx_dst[i] = idx_src[i] + cmd_base;
+					}
+					idx_src += cmd.ElemCount;
+					cmd_idx_dst += cmd.ElemCount;
+				}
+			}
+			else
+			{
+				memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+			}
+			vtx_base += cmd_list->VtxBuffer.Size;
+			idx_dst += cmd_list->IdxBuffer.Size;
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool BaseEngine::BoundDrawState::bindTexture(ImTextureID textureId)
+	{
+		if (isTextureValid && textureId == boundTextureId)
+		{
+			g_Stats.glCallsAvoided++;
+			return false;
+		}
+		boundTextureId = textureId;
+		isTextureValid = true;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool BaseEngine::BoundDrawState::bindClipRect(const ImVec4& clipRect)
+	{
+		if (isClipRectValid && DrawBatch::isSameClipRect(clipRect, boundClipRect))
+		{
+			g_Stats.glCallsAvoided++;
+			return false;
+		}
+		boundClipRect = clipRect;
+		isClipRectValid = true;
+		return true;
+	}
+
 	//--------------------------------------------------------------
 	GLuint BaseEngine::loadTextureImage2D(unsigned char * pixels, int width, int height)
 	{
@@ -106,4 +403,10 @@ namespace ofxImGui
 
 		return new_texture;
 	};
+
+	//--------------------------------------------------------------
+	void BaseEngine::deleteTexture(GLuint texture)
+	{
+		glDeleteTextures(1, &texture);
+	}
 }
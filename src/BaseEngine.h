@@ -2,11 +2,162 @@
 
 #include "ofEvents.h"
 #include "ofAppBaseWindow.h"
+#include "imgui.h"
+
+#include <atomic>
 
 #define OFFSETOF(TYPE, ELEMENT) ((size_t)&(((TYPE *)0)->ELEMENT))
 
 namespace ofxImGui
 {
+	// The last kNumSamples durations of one phase, in milliseconds
+	struct TimingHistory
+	{
+		static const int kNumSamples = 120;
+
+		float samples[kNumSamples] = { 0 };     // ring buffer, next is the oldest once full
+		int count = 0;
+		int next = 0;
+		float sum = 0.0f;
+
+		void add(float milliseconds);
+		void clear();
+
+		bool isEmpty() const
+		{
+			return count == 0;
+		}
+
+		float getLast() const;
+		float getAverage() const;
+
+		// percentile in [0, 100], e.g. 50 for the median
+		float getPercentile(float percentile) const;
+	};
+
+	// Time the GUI takes per frame, recorded while BaseEngine::setTiming() is on
+	struct FrameTimings
+	{
+		TimingHistory newFrame;     // CPU, ImGui::NewFrame() in Gui::begin()
+		TimingHistory render;       // CPU, ImGui::Render() in Gui::end(), without the draw
+		TimingHistory draw;         // CPU, recording the draw calls in the engine
+		TimingHistory gpuDraw;      // GPU, executing them. Arrives a few frames late, empty when the engine cannot measure it
+		uint64_t drawMicros = 0;    // total of the draw timings, to keep draws made by Render() out of render
+
+		void clear()
+		{
+			newFrame.clear();
+			render.clear();
+			draw.clear();
+			gpuDraw.clear();
+		}
+	};
+
+	// Per-frame counters filled in by the backends
+	struct RenderStats
+	{
+		unsigned int drawCalls = 0;         // draw calls issued
+		unsigned int mergedDrawCalls = 0;   // draw commands folded into the previous draw call
+		unsigned int glCallsAvoided = 0;    // GL queries and redundant state changes that were skipped
+		bool isCachedFrame = false;         // the previous GUI output was reused as is
+		FrameTimings timings;               // rolling, not reset per frame
+
+		void resetCounters()
+		{
+			drawCalls = 0;
+			mergedDrawCalls = 0;
+			glCallsAvoided = 0;
+			isCachedFrame = false;
+		}
+
+		// What the engine records while drawing, leaves the newFrame and render timings of Gui
+		void copyDrawStats(const RenderStats& other)
+		{
+			drawCalls = other.drawCalls;
+			mergedDrawCalls = other.mergedDrawCalls;
+			glCallsAvoided = other.glCallsAvoided;
+			isCachedFrame = other.isCachedFrame;
+			timings.draw = other.timings.draw;
+			timings.gpuDraw = other.timings.gpuDraw;
+		}
+	};
+
+	// Time spent in one phase of the engine setup
+	struct SetupTiming
+	{
+		std::string phase;
+		float milliseconds;
+	};
+
+	// Consecutive draw commands of a list that share texture, clip rectangle and
+	// vertex offset and can be drawn with a single call
+	struct DrawBatch
+	{
+		ImTextureID textureId = nullptr;
+		ImVec4 clipRect;
+		unsigned int vtxOffset = 0;     // ImDrawCmd::VtxOffset, added to the indices
+		unsigned int idxOffset = 0;     // first index, counted in indices
+		unsigned int elemCount = 0;
+
+		bool isEmpty() const
+		{
+			return elemCount == 0;
+		}
+
+		static bool isSameClipRect(const ImVec4& a, const ImVec4& b)
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+		}
+
+		static bool isClipRectEmpty(const ImVec4& r)
+		{
+			return r.z <= r.x || r.w <= r.y;
+		}
+
+		// From screen to framebuffer coordinates, the draw data itself is never scaled
+		static ImVec4 scaleClipRect(const ImVec4& r, const ImVec2& scale)
+		{
+			return ImVec4(r.x * scale.x, r.y * scale.y, r.z * scale.x, r.w * scale.y);
+		}
+
+		// Appends pcmd when it uses the same state and its indices directly follow the batch.
+		// The clip rectangle can be ignored when the backend clips without changing state.
+		bool merge(const ImDrawCmd* pcmd, unsigned int idx_offset, bool compare_clip_rect = true)
+		{
+			if (isEmpty() || pcmd->TextureId != textureId || pcmd->VtxOffset != vtxOffset || idx_offset != idxOffset + elemCount || (compare_clip_rect && !isSameClipRect(pcmd->ClipRect, clipRect)))
+			{
+				return false;
+			}
+			elemCount += pcmd->ElemCount;
+			return true;
+		}
+
+		void reset(const ImDrawCmd* pcmd, unsigned int idx_offset)
+		{
+			textureId = pcmd->TextureId;
+			clipRect = pcmd->ClipRect;
+			vtxOffset = pcmd->VtxOffset;
+			idxOffset = idx_offset;
+			elemCount = pcmd->ElemCount;
+		}
+
+		void clear()
+		{
+			elemCount = 0;
+		}
+	};
+
+	// Vertex layout of setCompactVertices(), 12 bytes instead of the 20 of ImDrawVert.
+	// Positions are fixed point, kPosScale steps per pixel, UVs are normalized.
+	struct CompactDrawVert
+	{
+		static const int kPosScale = 4;
+
+		int16_t pos[2];
+		uint16_t uv[2];
+		ImU32 col;
+	};
+
 	class BaseEngine
 	{
 	public:
@@ -22,7 +173,9 @@ namespace ofxImGui
 		virtual bool createDeviceObjects() = 0;
 		virtual void invalidateDeviceObjects() = 0;
 
-		virtual void draw() {};
+		// draw() renders the current ImGui frame, drawData() a given one, e.g. a DrawDataSnapshot
+		virtual void draw() { drawData(ImGui::GetDrawData()); };
+		virtual void drawData(ImDrawData * draw_data) {};
 
 		virtual void onMouseDragged(ofMouseEventArgs& event);
 		virtual void onMousePressed(ofMouseEventArgs& event);
@@ -32,11 +185,43 @@ namespace ofxImGui
 		virtual void onKeyReleased(ofKeyEventArgs& event) = 0;
 		virtual void onWindowResized(ofResizeEventArgs& window);
 
+		// Count input events for the reactive mode, takeInputEvents() returns and resets the count
+		void addInputTracking();
+		void removeInputTracking();
+		unsigned int takeInputEvents();
+
+		void onMouseInput(ofMouseEventArgs& event);
+		void onKeyInput(ofKeyEventArgs& event);
+		void onWindowInput(ofResizeEventArgs& window);
+
 		virtual GLuint loadTextureImage2D(unsigned char * pixels, int width, int height);
+		virtual void deleteTexture(GLuint texture);
+
+		// Phases of the last setup(), the last entry is the whole setup
+		const std::vector<SetupTiming>& getSetupTimings() const;
 
 		static const char* getClipboardString(void * userData);
 		static void setClipboardString(void * userData, const char * text);
 
+		// Upload all command lists of a frame as one vertex and one index buffer.
+		// With rebase_indices the indices are offset to address the merged vertex buffer, with
+		// ImDrawCmd::VtxOffset included, which the caller must keep within the range of ImDrawIdx.
+		static void setMergedUpload(bool enabled);
+		static void mergeDrawData(ImDrawData * draw_data, bool rebase_indices = false);
+
+		// Upload CompactDrawVert vertices, converted at render time. Frames with positions beyond
+		// +-8192 pixels or UVs outside [0, 1] are uploaded as ImDrawVert. Not used by the fixed
+		// function path of EngineGLFW.
+		static void setCompactVertices(bool enabled);
+
+		// Like mergeDrawData, with the vertices converted to g_CompactVtxStaging.
+		// Returns false, leaving the staging buffers undefined, when a vertex does not fit.
+		static bool mergeCompactDrawData(ImDrawData * draw_data, bool rebase_indices = false);
+
+		// Record CPU and GPU timings into g_Stats.timings, the histories are cleared when it is turned on.
+		// The draw histories are cleared by the next draw, on the thread that draws.
+		static void setTiming(bool enabled);
+
 		static int g_ShaderHandle;
 		static int g_VertHandle;
 		static int g_FragHandle;
@@ -51,10 +236,91 @@ namespace ofxImGui
 		static unsigned int g_VaoHandle;
 		static unsigned int g_ElementsHandle;
 
+		static RenderStats g_Stats;
+
+		static bool g_UseMergedUpload;
+		static thread_local bool g_PremultipliedAlphaTarget;    // blend so the target ends up with premultiplied alpha, set by the thread drawing
+		static ImVector<ImDrawVert> g_VtxStaging;
+		static ImVector<ImDrawIdx> g_IdxStaging;
+		static bool g_UseCompactVertices;
+		static ImVector<CompactDrawVert> g_CompactVtxStaging;
+		static std::atomic<bool> g_UseTiming;
+		static std::atomic<bool> g_ClearDrawTimings;    // set by setTiming(), cleared by the next addDrawTiming()
+
 		bool mousePressed[5] = { false };
+		bool mouseLatched[5] = { false };       // pressed since the last frame, so short clicks are not lost
+		std::vector<int> latchedKeys;           // keycodes pressed since the last frame
+		unsigned int pendingInputEvents = 0;
 
 	protected:
+		// Texture and clip rectangle a backend has set, so batches using the same ones do not set them
+		// again. Each set that is skipped counts as a call avoided.
+		class BoundDrawState
+		{
+		public:
+			// Whether the texture or clip rectangle has to be set, they are then remembered as set
+			bool bindTexture(ImTextureID textureId);
+			bool bindClipRect(const ImVec4& clipRect);
+
+			// False until the first texture is bound and after user callbacks, which may change any state
+			bool isValid() const { return isTextureValid; }
+			void invalidate() { isTextureValid = isClipRectValid = false; }
+
+			// For backends where the clip rectangle belongs to the texture's state
+			void invalidateClipRect() { isClipRectValid = false; }
+
+		private:
+			bool isTextureValid = false;
+			bool isClipRectValid = false;
+			ImTextureID boundTextureId = nullptr;
+			ImVec4 boundClipRect;
+		};
+
+		// Walks the commands of a list and calls draw_batch(const DrawBatch&) for every run of
+		// consecutive commands that can be drawn with one call. Commands without area are skipped,
+		// user callbacks end the batch, are called, and invalidate state.
+		template<typename DrawBatchFn>
+		static void drawListBatches(const ImDrawList* cmd_list, BoundDrawState& state, DrawBatchFn draw_batch, bool compare_clip_rect = true)
+		{
+			DrawBatch batch;
+			unsigned int idx_offset = 0;
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+				if (pcmd->UserCallback)
+				{
+					if (!batch.isEmpty()) draw_batch(batch);
+					batch.clear();
+					pcmd->UserCallback(cmd_list, pcmd);
+					state.invalidate();
+				}
+				else if (DrawBatch::isClipRectEmpty(pcmd->ClipRect))
+				{
+					// Nothing to draw, also ends the batch since the indices are no longer contiguous
+				}
+				else if (batch.merge(pcmd, idx_offset, compare_clip_rect))
+				{
+					g_Stats.mergedDrawCalls++;
+				}
+				else
+				{
+					if (!batch.isEmpty()) draw_batch(batch);
+					batch.reset(pcmd, idx_offset);
+				}
+				idx_offset += pcmd->ElemCount;
+			}
+			if (!batch.isEmpty()) draw_batch(batch);
+		}
+
+		void addSetupTiming(const std::string& phase, uint64_t startMicros);
+
+		// Adds the CPU time of a draw that started at startMicros, when timing is on
+		static void addDrawTiming(uint64_t startMicros);
+
+		static void mergeIndices(ImDrawData * draw_data, bool rebase_indices);
+
 		bool isSetup;
+		std::vector<SetupTiming> setupTimings;
 	};
 }
 
@@ -0,0 +1,137 @@
+#include "DrawDataSnapshot.h"
+
+#include <cstring>
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	template<typename T>
+	static void copyVector(ImVector<T>& dst, const ImVector<T>& src)
+	{
+		// ImVector::operator= frees and reallocates, resize() keeps the capacity
+		dst.resize(src.Size);
+		if (src.Size > 0)
+		{
+			memcpy(dst.Data, src.Data, (size_t)src.Size * sizeof(T));
+		}
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataSnapshot::copyFrom(const ImDrawData * draw_data)
+	{
+		if (!draw_data || !draw_data->Valid)
+		{
+			clear();
+			return;
+		}
+
+		while ((int)lists.size() < draw_data->CmdListsCount)
+		{
+			lists.emplace_back(new ImDrawList(nullptr));
+			ownerNames.emplace_back();
+		}
+		listPointers.resize(draw_data->CmdListsCount);
+
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* src = draw_data->CmdLists[n];
+			ImDrawList* dst = lists[n].get();
+			copyVector(dst->CmdBuffer, src->CmdBuffer);
+			copyVector(dst->IdxBuffer, src->IdxBuffer);
+			copyVector(dst->VtxBuffer, src->VtxBuffer);
+			dst->Flags = src->Flags;
+			if (src->_OwnerName)
+			{
+				// assign() keeps the capacity, like the buffers
+				ownerNames[n].assign(src->_OwnerName);
+				dst->_OwnerName = ownerNames[n].c_str();
+			}
+			else
+			{
+				dst->_OwnerName = nullptr;
+			}
+			listPointers[n] = dst;
+		}
+
+		drawData.Valid = true;
+		drawData.CmdLists = listPointers.Data;
+		drawData.CmdListsCount = draw_data->CmdListsCount;
+		drawData.TotalIdxCount = draw_data->TotalIdxCount;
+		drawData.TotalVtxCount = draw_data->TotalVtxCount;
+		drawData.DisplayPos = draw_data->DisplayPos;
+		drawData.DisplaySize = draw_data->DisplaySize;
+		drawData.FramebufferScale = draw_data->FramebufferScale;
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataSnapshot::clear()
+	{
+		drawData.Clear();
+		listPointers.resize(0);
+	}
+
+	//--------------------------------------------------------------
+	ImDrawData * DrawDataSnapshot::getDrawData()
+	{
+		return drawData.Valid ? &drawData : nullptr;
+	}
+
+	//--------------------------------------------------------------
+	DrawDataHandoff::DrawDataHandoff()
+		: writeIndex(0)
+		, readyIndex(-1)
+		, readIndex(-1)
+	{
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataHandoff::push(const ImDrawData * draw_data)
+	{
+		// Only the index swap is locked, copying runs alongside the drawing thread
+		snapshots[writeIndex].copyFrom(draw_data);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		int written = writeIndex;
+		if (readyIndex >= 0)
+		{
+			// The previous frame was never drawn, write over it next
+			writeIndex = readyIndex;
+		}
+		else
+		{
+			// Neither the frame being drawn nor the one just written
+			writeIndex = 3 - written - (readIndex >= 0 ? readIndex : (written == 0 ? 1 : 0));
+		}
+		readyIndex = written;
+	}
+
+	//--------------------------------------------------------------
+	ImDrawData * DrawDataHandoff::acquire(bool * is_new)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		bool has_new = readyIndex >= 0;
+		if (has_new)
+		{
+			readIndex = readyIndex;
+			readyIndex = -1;
+		}
+		if (is_new)
+		{
+			*is_new = has_new;
+		}
+		return readIndex >= 0 ? snapshots[readIndex].getDrawData() : nullptr;
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataHandoff::clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& snapshot : snapshots)
+		{
+			snapshot.clear();
+		}
+		writeIndex = 0;
+		readyIndex = -1;
+		readIndex = -1;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ofxImGui
+{
+	// A deep copy of ImDrawData that stays valid after the next ImGui::NewFrame().
+	// Buffers are kept between copies, once warmed up copying a frame does not allocate.
+	class DrawDataSnapshot
+	{
+	public:
+		void copyFrom(const ImDrawData * draw_data);
+		void clear();
+
+		// nullptr when nothing was copied
+		ImDrawData * getDrawData();
+
+	private:
+		ImDrawData drawData;
+		std::vector<std::unique_ptr<ImDrawList>> lists;     // grows to the most lists seen, never shrinks
+		std::vector<std::string> ownerNames;                // the lists' _OwnerName, the windows may be gone before drawing
+		ImVector<ImDrawList*> listPointers;
+	};
+
+	// Passes frames from the thread that builds the GUI to the thread that draws it.
+	// Each side works on its own snapshot and a third one holds the latest finished frame,
+	// so neither side waits for the other. Frames the drawing thread did not get to are dropped.
+	class DrawDataHandoff
+	{
+	public:
+		DrawDataHandoff();
+
+		// Building thread: copies the frame and makes it the latest
+		void push(const ImDrawData * draw_data);
+
+		// Drawing thread: the latest frame, valid until the next call. is_new is false when
+		// no frame was pushed since the previous call and the same snapshot is returned.
+		ImDrawData * acquire(bool * is_new = nullptr);
+
+		void clear();
+
+	private:
+		DrawDataSnapshot snapshots[3];
+		std::mutex mutex;
+		int writeIndex;
+		int readyIndex;     // -1 when the drawing thread already took the latest frame
+		int readIndex;      // -1 before the first frame
+	};
+}
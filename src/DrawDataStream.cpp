@@ -0,0 +1,357 @@
+#include "DrawDataStream.h"
+
+#include <cstring>
+
+namespace
+{
+	// Zero bytes that end a literal run, shorter gaps are cheaper to send as literals
+	const size_t kMinZeroRun = 4;
+
+	//--------------------------------------------------------------
+	template<typename T>
+	void put(std::vector<unsigned char>& out, const T& value)
+	{
+		size_t offset = out.size();
+		out.resize(offset + sizeof(T));
+		memcpy(&out[offset], &value, sizeof(T));
+	}
+
+	//--------------------------------------------------------------
+	void putVarint(std::vector<unsigned char>& out, size_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back((unsigned char)(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back((unsigned char)value);
+	}
+
+	// Bounds checked reads from a message
+	struct Reader
+	{
+		const unsigned char* data;
+		size_t size;
+		size_t pos;
+
+		template<typename T>
+		bool get(T& value)
+		{
+			if (size - pos < sizeof(T))
+			{
+				return false;
+			}
+			memcpy(&value, data + pos, sizeof(T));
+			pos += sizeof(T);
+			return true;
+		}
+	};
+
+	//--------------------------------------------------------------
+	bool getVarint(const unsigned char* in, size_t in_size, size_t& pos, size_t& value)
+	{
+		value = 0;
+		for (int shift = 0; pos < in_size && shift < 64; shift += 7)
+		{
+			unsigned char byte = in[pos++];
+			value |= (size_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	//--------------------------------------------------------------
+	template<typename T>
+	void encodeVector(const ImVector<T>& data, const ImVector<T>* prev, std::vector<unsigned char>& out)
+	{
+		put(out, (uint32_t)data.Size);
+		ofxImGui::encodeDelta((const unsigned char*)data.Data, (size_t)data.Size * sizeof(T),
+			prev ? (const unsigned char*)prev->Data : nullptr, prev ? (size_t)prev->Size * sizeof(T) : 0, out);
+	}
+
+	//--------------------------------------------------------------
+	template<typename T>
+	bool decodeVector(Reader& reader, ImVector<T>& data)
+	{
+		uint32_t count;
+		if (!reader.get(count) || count > (uint32_t)(1 << 26))
+		{
+			return false;
+		}
+		size_t prev_size = (size_t)data.Size * sizeof(T);
+		data.resize((int)count);
+		size_t read = ofxImGui::decodeDelta(reader.data + reader.pos, reader.size - reader.pos, (unsigned char*)data.Data, (size_t)count * sizeof(T), prev_size);
+		if (read == 0)
+		{
+			return false;
+		}
+		reader.pos += read;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool isDrawListValid(const ImDrawList* list)
+	{
+		// The backends index the buffers without checking, a received list must stay inside them
+		size_t idx_offset = 0;
+		for (const ImDrawCmd& cmd : list->CmdBuffer)
+		{
+			if (cmd.ElemCount > (size_t)list->IdxBuffer.Size - idx_offset)
+			{
+				return false;
+			}
+			const ImDrawIdx* idx = list->IdxBuffer.Data + idx_offset;
+			for (unsigned int i = 0; i < cmd.ElemCount; i++)
+			{
+				if ((uint64_t)cmd.VtxOffset + idx[i] >= (uint64_t)list->VtxBuffer.Size)
+				{
+					return false;
+				}
+			}
+			idx_offset += cmd.ElemCount;
+		}
+		return true;
+	}
+}
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	void encodeDelta(const unsigned char * data, size_t size, const unsigned char * prev, size_t prev_size, std::vector<unsigned char>& out)
+	{
+		// Runs of unchanged bytes alternate with literal runs of XORed bytes
+		auto delta = [&](size_t i) -> unsigned char { return i < prev_size ? data[i] ^ prev[i] : data[i]; };
+
+		size_t i = 0;
+		do
+		{
+			size_t zeros = 0;
+			while (i + zeros < size && delta(i + zeros) == 0)
+			{
+				zeros++;
+			}
+			i += zeros;
+
+			size_t literal_end = i;
+			size_t gap = 0;
+			while (literal_end + gap < size && gap < kMinZeroRun)
+			{
+				gap = delta(literal_end + gap) == 0 ? gap + 1 : 0;
+				if (gap == 0)
+				{
+					literal_end++;
+				}
+			}
+
+			putVarint(out, zeros);
+			putVarint(out, literal_end - i);
+			for (; i < literal_end; i++)
+			{
+				out.push_back(delta(i));
+			}
+		} while (i < size);
+	}
+
+	//--------------------------------------------------------------
+	size_t decodeDelta(const unsigned char * in, size_t in_size, unsigned char * data, size_t size, size_t prev_size)
+	{
+		size_t pos = 0;
+		size_t i = 0;
+		do
+		{
+			size_t zeros, literals;
+			if (!getVarint(in, in_size, pos, zeros) || !getVarint(in, in_size, pos, literals)
+				|| zeros > size - i || literals > size - i - zeros || literals > in_size - pos)
+			{
+				return 0;
+			}
+			for (size_t end = i + zeros; i < end; i++)
+			{
+				if (i >= prev_size) data[i] = 0;
+			}
+			for (size_t end = i + literals; i < end; i++)
+			{
+				data[i] = (i < prev_size ? data[i] : 0) ^ in[pos++];
+			}
+		} while (i < size);
+		return pos;
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataEncoder::encode(const ImDrawData * draw_data, ImTextureID font_texture, std::vector<unsigned char>& out)
+	{
+		ImDrawData* prev = hasPrevious ? previous.getDrawData() : nullptr;
+		int prev_count = prev ? prev->CmdListsCount : 0;
+		int count = draw_data && draw_data->Valid ? draw_data->CmdListsCount : 0;
+
+		put(out, (uint8_t)(hasPrevious ? 0 : 1));
+		put(out, draw_data ? draw_data->DisplayPos : ImVec2(0.0f, 0.0f));
+		put(out, draw_data ? draw_data->DisplaySize : ImVec2(0.0f, 0.0f));
+		put(out, (uint64_t)(intptr_t)font_texture);
+		put(out, (uint32_t)count);
+
+		for (int n = 0; n < count; n++)
+		{
+			const ImDrawList* list = draw_data->CmdLists[n];
+			const ImDrawList* prev_list = n < prev_count ? prev->CmdLists[n] : nullptr;
+			if (prev_list
+				&& list->CmdBuffer.Size == prev_list->CmdBuffer.Size && list->VtxBuffer.Size == prev_list->VtxBuffer.Size && list->IdxBuffer.Size == prev_list->IdxBuffer.Size
+				&& memcmp(list->CmdBuffer.Data, prev_list->CmdBuffer.Data, (size_t)list->CmdBuffer.Size * sizeof(ImDrawCmd)) == 0
+				&& memcmp(list->VtxBuffer.Data, prev_list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size * sizeof(ImDrawVert)) == 0
+				&& memcmp(list->IdxBuffer.Data, prev_list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size * sizeof(ImDrawIdx)) == 0)
+			{
+				put(out, (uint8_t)0);
+				continue;
+			}
+
+			put(out, (uint8_t)1);
+			put(out, (uint32_t)list->CmdBuffer.Size);
+			for (const ImDrawCmd& cmd : list->CmdBuffer)
+			{
+				put(out, (uint32_t)(cmd.UserCallback ? 0 : cmd.ElemCount));
+				put(out, cmd.ClipRect);
+				put(out, (uint64_t)(intptr_t)cmd.TextureId);
+				put(out, (uint32_t)cmd.VtxOffset);
+			}
+			encodeVector(list->VtxBuffer, prev_list ? &prev_list->VtxBuffer : nullptr, out);
+			encodeVector(list->IdxBuffer, prev_list ? &prev_list->IdxBuffer : nullptr, out);
+		}
+
+		previous.copyFrom(draw_data);
+		hasPrevious = true;
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataEncoder::reset()
+	{
+		previous.clear();
+		hasPrevious = false;
+	}
+
+	//--------------------------------------------------------------
+	bool DrawDataDecoder::decode(const unsigned char * data, size_t size)
+	{
+		if (!decodeFrame(data, size))
+		{
+			// Partly applied, nothing can follow until the next key frame
+			reset();
+			return false;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool DrawDataDecoder::decodeFrame(const unsigned char * data, size_t size)
+	{
+		Reader reader = { data, size, 0 };
+		uint8_t is_key_frame;
+		ImVec2 display_pos, display_size;
+		uint64_t remote_font_texture;
+		uint32_t count;
+		if (!reader.get(is_key_frame) || !reader.get(display_pos) || !reader.get(display_size) || !reader.get(remote_font_texture) || !reader.get(count)
+			|| count > 65536 || (!is_key_frame && !drawData.Valid))
+		{
+			return false;
+		}
+		if (is_key_frame)
+		{
+			reset();
+		}
+
+		// Lists past the previous frame start empty, as they did for the encoder
+		for (int n = drawData.Valid ? drawData.CmdListsCount : 0; n < (int)lists.size(); n++)
+		{
+			lists[n]->CmdBuffer.resize(0);
+			lists[n]->VtxBuffer.resize(0);
+			lists[n]->IdxBuffer.resize(0);
+		}
+		while (lists.size() < count)
+		{
+			lists.emplace_back(new ImDrawList(nullptr));
+		}
+		listPointers.resize((int)count);
+
+		int total_vtx = 0;
+		int total_idx = 0;
+		for (uint32_t n = 0; n < count; n++)
+		{
+			ImDrawList* list = lists[n].get();
+			listPointers[n] = list;
+
+			uint8_t is_changed;
+			if (!reader.get(is_changed))
+			{
+				return false;
+			}
+			if (is_changed)
+			{
+				uint32_t cmd_count;
+				if (!reader.get(cmd_count) || cmd_count > (uint32_t)(1 << 20))
+				{
+					return false;
+				}
+				list->CmdBuffer.resize((int)cmd_count);
+				for (ImDrawCmd& cmd : list->CmdBuffer)
+				{
+					uint32_t elem_count;
+					ImVec4 clip_rect;
+					uint64_t texture;
+					uint32_t vtx_offset;
+					if (!reader.get(elem_count) || !reader.get(clip_rect) || !reader.get(texture) || !reader.get(vtx_offset))
+					{
+						return false;
+					}
+					cmd = ImDrawCmd();
+					cmd.ElemCount = elem_count;
+					cmd.ClipRect = clip_rect;
+					cmd.TextureId = texture == remote_font_texture ? fontTexture : nullptr;
+					cmd.VtxOffset = vtx_offset;
+				}
+				if (!decodeVector(reader, list->VtxBuffer) || !decodeVector(reader, list->IdxBuffer) || !isDrawListValid(list))
+				{
+					return false;
+				}
+			}
+			total_vtx += list->VtxBuffer.Size;
+			total_idx += list->IdxBuffer.Size;
+		}
+
+		drawData.Valid = true;
+		drawData.CmdLists = listPointers.Data;
+		drawData.CmdListsCount = (int)count;
+		drawData.TotalVtxCount = total_vtx;
+		drawData.TotalIdxCount = total_idx;
+		drawData.DisplayPos = display_pos;
+		drawData.DisplaySize = display_size;
+		drawData.FramebufferScale = ImVec2(1.0f, 1.0f);     // not streamed, the viewer draws at its own scale
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataDecoder::reset()
+	{
+		drawData.Clear();
+		listPointers.resize(0);
+		for (auto& list : lists)
+		{
+			list->CmdBuffer.resize(0);
+			list->VtxBuffer.resize(0);
+			list->IdxBuffer.resize(0);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void DrawDataDecoder::setFontTexture(ImTextureID texture)
+	{
+		fontTexture = texture;
+	}
+
+	//--------------------------------------------------------------
+	ImDrawData * DrawDataDecoder::getDrawData()
+	{
+		return drawData.Valid ? &drawData : nullptr;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "DrawDataSnapshot.h"
+
+#include "imgui.h"
+
+#include <memory>
+#include <vector>
+
+namespace ofxImGui
+{
+	// Messages between RemoteServer and RemoteViewer, each sent as type, payload size and payload.
+	// Values are written in host byte order, both ends are expected to share it.
+	enum RemoteMessageType
+	{
+		REMOTE_MESSAGE_FRAME = 1,       // DrawDataEncoder output
+		REMOTE_MESSAGE_FONT_ATLAS,      // width, height and compressed RGBA pixels
+		REMOTE_MESSAGE_INPUT            // RemoteInputEvent
+	};
+
+	// Appends the run-length coded difference of data to prev, which may be shorter or empty.
+	// Unchanged bytes cost next to nothing, which covers most of an idle GUI.
+	void encodeDelta(const unsigned char * data, size_t size, const unsigned char * prev, size_t prev_size, std::vector<unsigned char>& out);
+
+	// Turns the prev_size bytes at data into the encoded ones, data holds size bytes.
+	// Returns the number of bytes read from in, 0 when the input is malformed.
+	size_t decodeDelta(const unsigned char * in, size_t in_size, unsigned char * data, size_t size, size_t prev_size);
+
+	// Serializes frames as changes to the previous one: command lists equal to those of
+	// the previous frame are skipped, vertices and indices are delta coded.
+	// User callbacks are not sent, their commands arrive empty.
+	class DrawDataEncoder
+	{
+	public:
+		void encode(const ImDrawData * draw_data, ImTextureID font_texture, std::vector<unsigned char>& out);
+
+		// The next frame is encoded whole, e.g. for a new viewer
+		void reset();
+
+	private:
+		DrawDataSnapshot previous;
+		bool hasPrevious = false;
+	};
+
+	// Rebuilds the frames of a DrawDataEncoder, which must see every frame encoded since its reset()
+	class DrawDataDecoder
+	{
+	public:
+		// Returns false on malformed input, including indices outside the vertices or element counts
+		// past the indices. Frames are then dropped until the encoder is reset() too.
+		bool decode(const unsigned char * data, size_t size);
+		void reset();
+
+		// Textures of the sender are replaced by local ones, everything but the font is dropped
+		void setFontTexture(ImTextureID texture);
+
+		// The last decoded frame, nullptr before the first one
+		ImDrawData * getDrawData();
+
+	private:
+		bool decodeFrame(const unsigned char * data, size_t size);
+
+		std::vector<std::unique_ptr<ImDrawList>> lists;
+		ImVector<ImDrawList*> listPointers;
+		ImDrawData drawData;
+		ImTextureID fontTexture = nullptr;
+	};
+}
@@ -0,0 +1,218 @@
+#include "DrawListProfiler.h"
+
+#include "imgui_internal.h"
+
+#include <algorithm>
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	DrawListProfiler::DrawListProfiler()
+		: frame(0)
+		, historyIndex(0)
+		, sortMetric(METRIC_INDICES)
+		, enabled(false)
+	{
+	}
+
+	//--------------------------------------------------------------
+	void DrawListProfiler::setEnabled(bool enabled_)
+	{
+		if (enabled_ && !enabled)
+		{
+			clear();
+		}
+		enabled = enabled_;
+	}
+
+	//--------------------------------------------------------------
+	bool DrawListProfiler::isEnabled() const
+	{
+		return enabled;
+	}
+
+	//--------------------------------------------------------------
+	void DrawListProfiler::clear()
+	{
+		entries.clear();
+	}
+
+	//--------------------------------------------------------------
+	void DrawListProfiler::update(const ImDrawData * draw_data)
+	{
+		if (!enabled || !draw_data || !draw_data->Valid)
+		{
+			return;
+		}
+
+		frame++;
+		historyIndex = (historyIndex + 1) % kHistorySize;
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (frame - it->second.lastFrame > kMaxUnusedFrames)
+			{
+				it = entries.erase(it);
+				continue;
+			}
+			for (int m = 0; m < kNumMetrics; m++)
+			{
+				it->second.history[m][historyIndex] = 0.0f;
+			}
+			++it;
+		}
+
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			const char* name = cmd_list->_OwnerName ? cmd_list->_OwnerName : "";
+
+			// Same hash as the window id, names are not copied after the first frame
+			ImGuiID id = ImHash(name, 0);
+			auto it = entries.find(id);
+			if (it == entries.end())
+			{
+				it = entries.emplace(id, Entry()).first;
+				it->second.name = name;
+				std::fill(&it->second.history[0][0], &it->second.history[0][0] + kNumMetrics * kHistorySize, 0.0f);
+			}
+			Entry& entry = it->second;
+			entry.lastFrame = frame;
+
+			unsigned int draw_commands = 0;
+			unsigned int texture_switches = 0;
+			ImTextureID last_texture = nullptr;
+			for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+			{
+				if (cmd.UserCallback || cmd.ElemCount == 0)
+				{
+					continue;
+				}
+				if (draw_commands > 0 && cmd.TextureId != last_texture)
+				{
+					texture_switches++;
+				}
+				last_texture = cmd.TextureId;
+				draw_commands++;
+			}
+
+			// Added up, a window can have more than one list in the frame
+			entry.history[METRIC_VERTICES][historyIndex] += (float)cmd_list->VtxBuffer.Size;
+			entry.history[METRIC_INDICES][historyIndex] += (float)cmd_list->IdxBuffer.Size;
+			entry.history[METRIC_DRAW_COMMANDS][historyIndex] += (float)draw_commands;
+			entry.history[METRIC_TEXTURE_SWITCHES][historyIndex] += (float)texture_switches;
+		}
+	}
+
+	//--------------------------------------------------------------
+	float DrawListProfiler::getValue(const Entry& entry, Metric metric) const
+	{
+		return entry.history[metric][historyIndex];
+	}
+
+	//--------------------------------------------------------------
+	std::vector<const DrawListProfiler::Entry*> DrawListProfiler::getSortedEntries(Metric metric) const
+	{
+		std::vector<const Entry*> sorted;
+		sorted.reserve(entries.size());
+		for (const auto& entry : entries)
+		{
+			sorted.push_back(&entry.second);
+		}
+		std::sort(sorted.begin(), sorted.end(), [this, metric](const Entry* a, const Entry* b)
+		{
+			float value_a = getValue(*a, metric);
+			float value_b = getValue(*b, metric);
+			return value_a != value_b ? value_a > value_b : a->name < b->name;
+		});
+		return sorted;
+	}
+
+	//--------------------------------------------------------------
+	const char* DrawListProfiler::getMetricName(Metric metric)
+	{
+		switch (metric)
+		{
+		case METRIC_VERTICES: return "Vertices";
+		case METRIC_INDICES: return "Indices";
+		case METRIC_DRAW_COMMANDS: return "Draw commands";
+		case METRIC_TEXTURE_SWITCHES: return "Texture switches";
+		default: return "";
+		}
+	}
+
+	//--------------------------------------------------------------
+	void DrawListProfiler::draw(bool* p_open)
+	{
+		if (!ImGui::Begin("Draw lists", p_open))
+		{
+			ImGui::End();
+			return;
+		}
+		if (!enabled)
+		{
+			ImGui::TextDisabled("Profiling is off");
+			ImGui::End();
+			return;
+		}
+
+		std::vector<const Entry*> sorted = getSortedEntries(sortMetric);
+		float totals[kNumMetrics] = { 0.0f };
+		for (const Entry* entry : sorted)
+		{
+			for (int m = 0; m < kNumMetrics; m++)
+			{
+				totals[m] += getValue(*entry, (Metric)m);
+			}
+		}
+		ImGui::Text("%d windows, %.0f vertices, %.0f indices, %.0f draw commands, %.0f texture switches",
+			(int)sorted.size(), totals[METRIC_VERTICES], totals[METRIC_INDICES], totals[METRIC_DRAW_COMMANDS], totals[METRIC_TEXTURE_SWITCHES]);
+		ImGui::Separator();
+
+		ImGui::Columns(kNumMetrics + 2, "##draw_lists");
+		ImGui::TextUnformatted("Window");
+		ImGui::NextColumn();
+		for (int m = 0; m < kNumMetrics; m++)
+		{
+			// Clicking a header sorts by it and plots it
+			if (ImGui::Selectable(getMetricName((Metric)m), sortMetric == m))
+			{
+				sortMetric = (Metric)m;
+			}
+			ImGui::NextColumn();
+		}
+		ImGui::TextUnformatted("History");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		// Oldest first, the slot after the last frame
+		int history_offset = (historyIndex + 1) % kHistorySize;
+		for (const Entry* entry : sorted)
+		{
+			ImGui::PushID(entry);
+			ImGui::Selectable("##row", false, ImGuiSelectableFlags_SpanAllColumns);
+			if (ImGui::IsItemHovered())
+			{
+				// Outline the window, like the metrics window does
+				ImGuiWindow* window = ImGui::FindWindowByName(entry->name.c_str());
+				if (window)
+				{
+					ImGui::GetOverlayDrawList()->AddRect(window->Pos, ImVec2(window->Pos.x + window->Size.x, window->Pos.y + window->Size.y), IM_COL32(255, 255, 0, 255));
+				}
+			}
+			// Shown as is, names often contain ##
+			ImGui::SameLine();
+			ImGui::TextUnformatted(entry->name.c_str());
+			ImGui::NextColumn();
+			for (int m = 0; m < kNumMetrics; m++)
+			{
+				ImGui::Text("%.0f", getValue(*entry, (Metric)m));
+				ImGui::NextColumn();
+			}
+			ImGui::PlotLines("##history", entry->history[sortMetric], kHistorySize, history_offset, nullptr, 0.0f, FLT_MAX, ImVec2(-1.0f, ImGui::GetTextLineHeight()));
+			ImGui::NextColumn();
+			ImGui::PopID();
+		}
+		ImGui::Columns(1);
+		ImGui::End();
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ofxImGui
+{
+	// Geometry and draw command counts of every window, from the draw data of each frame, to find
+	// the windows that are expensive to draw. Like the draw lists section of ImGui's metrics window,
+	// but with history, and cheap enough to leave on: only the command buffers are walked.
+	class DrawListProfiler
+	{
+	public:
+		enum Metric
+		{
+			METRIC_VERTICES,
+			METRIC_INDICES,
+			METRIC_DRAW_COMMANDS,       // commands with geometry, callbacks are not counted
+			METRIC_TEXTURE_SWITCHES,    // commands using another texture than the one before
+			kNumMetrics
+		};
+
+		static const int kHistorySize = 120;            // frames kept per window
+		static const unsigned int kMaxUnusedFrames = 300;   // windows not drawn for this long are dropped
+
+		// One window, or the overlay draw list. Child windows have their own.
+		struct Entry
+		{
+			std::string name;
+			unsigned int lastFrame = 0;
+			float history[kNumMetrics][kHistorySize];  // per frame, 0 in frames the window was not drawn in
+		};
+
+		DrawListProfiler();
+
+		void setEnabled(bool enabled);
+		bool isEnabled() const;
+
+		// Counts a frame, call once per frame after ImGui::Render()
+		void update(const ImDrawData * draw_data);
+		void clear();
+
+		// Value of the last frame
+		float getValue(const Entry& entry, Metric metric) const;
+
+		// Most expensive first
+		std::vector<const Entry*> getSortedEntries(Metric metric) const;
+
+		// Window with a row per window, sorted by the metric whose header was clicked, with the
+		// history of that metric. Hovering a row outlines the window.
+		void draw(bool* p_open = nullptr);
+
+		static const char* getMetricName(Metric metric);
+
+	private:
+		std::unordered_map<ImGuiID, Entry> entries;     // by window id, the hash of the name
+		unsigned int frame;
+		int historyIndex;       // slot of the last frame in Entry::history
+		Metric sortMetric;
+		bool enabled;
+	};
+}
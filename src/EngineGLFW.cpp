@@ -4,17 +4,40 @@
 
 #include "ofAppGLFWWindow.h"
 #include "ofGLProgrammableRenderer.h"
+#include "ofGLUtils.h"
+#include "ofGraphics.h"
 #include "GLFW/glfw3.h"
+#include "ShaderCache.h"
+#include "Tracer.h"
+
+#include <limits>
 
 namespace ofxImGui
 {
 	GLuint EngineGLFW::g_FontTexture = 0;
 
+	bool EngineGLFW::g_UsePersistentMapping = false;
+	bool EngineGLFW::g_UseOwnedState = false;
+	bool EngineGLFW::g_UseShaderClipping = false;
+	bool EngineGLFW::g_UseFixedBufferObjects = false;
+
+	GLuint EngineGLFW::g_ClipShaderHandle = 0;
+	GLuint EngineGLFW::g_ClipVboHandle = 0;
+	GLint EngineGLFW::g_ClipUniformLocationTex = 0;
+	GLint EngineGLFW::g_ClipUniformLocationProjMtx = 0;
+	GLint EngineGLFW::g_AttribLocationClipRect = 0;
+	ImVector<ImVec4> EngineGLFW::g_ClipStaging;
+	PersistentRing EngineGLFW::g_Ring;
+	GpuTimer EngineGLFW::g_GpuTimer;
+
 	//--------------------------------------------------------------
 	void EngineGLFW::setup(bool autoDraw)
 	{
 		if (isSetup) return;
 
+		setupTimings.clear();
+		uint64_t setupStart = ofGetElapsedTimeMicros();
+
 		ImGuiIO& io = ImGui::GetIO();
 
 		io.KeyMap[ImGuiKey_Tab] = GLFW_KEY_TAB;
@@ -53,6 +76,7 @@ namespace ofxImGui
 
 		io.SetClipboardTextFn = &BaseEngine::setClipboardString;
 		io.GetClipboardTextFn = &BaseEngine::getClipboardString;
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;    // draws lists past 64K vertices with 16-bit indices
 
 		createDeviceObjects();
 
@@ -66,6 +90,9 @@ namespace ofxImGui
 		ofAddListener(ofEvents().mouseDragged, (BaseEngine*)this, &BaseEngine::onMouseDragged);
 		ofAddListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
 		ofAddListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		addInputTracking();
+
+		addSetupTiming("total", setupStart);
 
 		isSetup = true;
 	}
@@ -87,6 +114,7 @@ namespace ofxImGui
         ofRemoveListener(ofEvents().mouseDragged, (BaseEngine*)this, &BaseEngine::onMouseDragged);
         ofRemoveListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
         ofRemoveListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+        removeInputTracking();
         
 		invalidateDeviceObjects();
 
@@ -94,15 +122,15 @@ namespace ofxImGui
 	}
 
 	//--------------------------------------------------------------
-	void EngineGLFW::draw()
+	void EngineGLFW::drawData(ImDrawData * draw_data)
 	{
 		if (ofIsGLProgrammableRenderer())
 		{
-			programmableDrawData(ImGui::GetDrawData());
+			programmableDrawData(draw_data);
 		}
 		else
 		{
-			fixedDrawData(ImGui::GetDrawData());
+			fixedDrawData(draw_data);
 		}
 	}
 
@@ -137,6 +165,7 @@ namespace ofxImGui
 		{
 			remapToGLFWConvention(button);
 			mousePressed[button] = true;
+			mouseLatched[button] = true;
 		}
 	}
 
@@ -155,117 +184,511 @@ namespace ofxImGui
 	void EngineGLFW::programmableDrawData(ImDrawData * draw_data)
 	{
 		// Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
-		ImGuiIO& io = ImGui::GetIO();
-		int fb_width = (int)(io.DisplaySize.x * io.DisplayFramebufferScale.x);
-		int fb_height = (int)(io.DisplaySize.y * io.DisplayFramebufferScale.y);
+		int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
 		if (fb_width == 0 || fb_height == 0)
 			return;
-		draw_data->ScaleClipRects(io.DisplayFramebufferScale);
+
+		g_Stats.resetCounters();
+		uint64_t start_micros = ofGetElapsedTimeMicros();
+		Tracer::begin("Draw");
+		bool isGpuTiming = g_UseTiming && g_GpuTimer.begin(g_Stats.timings.gpuDraw);
+
+		bool isShaderClipping = g_UseShaderClipping && g_ClipShaderHandle;
 
 		// Backup GL state
-		GLenum last_active_texture; glGetIntegerv(GL_ACTIVE_TEXTURE, (GLint*)&last_active_texture);
-		glActiveTexture(GL_TEXTURE0);
-		GLint last_program; glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
-		GLint last_texture; glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
-		GLint last_sampler; glGetIntegerv(GL_SAMPLER_BINDING, &last_sampler);
-		GLint last_array_buffer; glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
-		GLint last_element_array_buffer; glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &last_element_array_buffer);
-		GLint last_vertex_array; glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
-		GLint last_polygon_mode[2]; glGetIntegerv(GL_POLYGON_MODE, last_polygon_mode);
-		GLint last_viewport[4]; glGetIntegerv(GL_VIEWPORT, last_viewport);
-		GLint last_scissor_box[4]; glGetIntegerv(GL_SCISSOR_BOX, last_scissor_box);
-		GLenum last_blend_src_rgb; glGetIntegerv(GL_BLEND_SRC_RGB, (GLint*)&last_blend_src_rgb);
-		GLenum last_blend_dst_rgb; glGetIntegerv(GL_BLEND_DST_RGB, (GLint*)&last_blend_dst_rgb);
-		GLenum last_blend_src_alpha; glGetIntegerv(GL_BLEND_SRC_ALPHA, (GLint*)&last_blend_src_alpha);
-		GLenum last_blend_dst_alpha; glGetIntegerv(GL_BLEND_DST_ALPHA, (GLint*)&last_blend_dst_alpha);
-		GLenum last_blend_equation_rgb; glGetIntegerv(GL_BLEND_EQUATION_RGB, (GLint*)&last_blend_equation_rgb);
-		GLenum last_blend_equation_alpha; glGetIntegerv(GL_BLEND_EQUATION_ALPHA, (GLint*)&last_blend_equation_alpha);
-		GLboolean last_enable_blend = glIsEnabled(GL_BLEND);
-		GLboolean last_enable_cull_face = glIsEnabled(GL_CULL_FACE);
-		GLboolean last_enable_depth_test = glIsEnabled(GL_DEPTH_TEST);
-		GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
+		GLStateShadow app_state;
+		if (g_UseOwnedState)
+		{
+			app_state.queryFromRenderer();
+			g_Stats.glCallsAvoided += GLStateShadow::kNumQueries - GLStateShadow::kNumOwnedQueries;
+		}
+		else
+		{
+			app_state.query();
+		}
 
 		// Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled, polygon fill
-		glEnable(GL_BLEND);
-		glBlendEquation(GL_FUNC_ADD);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_CULL_FACE);
-		glDisable(GL_DEPTH_TEST);
-		glEnable(GL_SCISSOR_TEST);
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		GLStateShadow gui_state = app_state;
+		gui_state.activeTexture = GL_TEXTURE0;
+		gui_state.program = isShaderClipping ? g_ClipShaderHandle : g_ShaderHandle;
+		gui_state.sampler = 0; // Rely on combined texture/sampler state.
+		gui_state.vertexArray = g_VaoHandle;
+		gui_state.polygonMode = GL_FILL;
+		gui_state.blend = true;
+		gui_state.blendEquationRgb = gui_state.blendEquationAlpha = GL_FUNC_ADD;
+		gui_state.blendSrcRgb = GL_SRC_ALPHA;
+		gui_state.blendSrcAlpha = g_PremultipliedAlphaTarget ? GL_ONE : GL_SRC_ALPHA;
+		gui_state.blendDstRgb = gui_state.blendDstAlpha = GL_ONE_MINUS_SRC_ALPHA;
+		gui_state.cullFace = false;
+		gui_state.depthTest = false;
+		gui_state.scissorTest = !isShaderClipping;
 
 		// Setup viewport, orthographic projection matrix
-		glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
+		gui_state.viewport[0] = 0;
+		gui_state.viewport[1] = 0;
+		gui_state.viewport[2] = fb_width;
+		gui_state.viewport[3] = fb_height;
+
+		GLStateShadow current_state = app_state;
+		g_Stats.glCallsAvoided += std::max(0, GLStateShadow::kNumSetupCalls - GLStateShadow::apply(current_state, gui_state));
+
+		// Compact positions are fixed point, the projection scales them back to pixels
+		bool isCompact = g_UseCompactVertices && mergeCompactDrawData(draw_data);
+		const float pos_scale = isCompact ? 1.0f / CompactDrawVert::kPosScale : 1.0f;
 		const float ortho_projection[4][4] =
 		{
-			{ 2.0f/io.DisplaySize.x, 0.0f,                   0.0f, 0.0f },
-			{ 0.0f,                  2.0f/-io.DisplaySize.y, 0.0f, 0.0f },
-			{ 0.0f,                  0.0f,                  -1.0f, 0.0f },
-			{-1.0f,                  1.0f,                   0.0f, 1.0f },
+			{ 2.0f*pos_scale/draw_data->DisplaySize.x, 0.0f,                                       0.0f, 0.0f },
+			{ 0.0f,                                     2.0f*pos_scale/-draw_data->DisplaySize.y, 0.0f, 0.0f },
+			{ 0.0f,                                     0.0f,                                      -1.0f, 0.0f },
+			{-1.0f,                                     1.0f,                                       0.0f, 1.0f },
+		};
+		glUniform1i(isShaderClipping ? g_ClipUniformLocationTex : g_UniformLocationTex, 0);
+		glUniformMatrix4fv(isShaderClipping ? g_ClipUniformLocationProjMtx : g_UniformLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
+
+		if (!g_UsePersistentMapping && g_Ring.vboHandle)
+		{
+			destroyRing();
+		}
+
+		GLint vtx_base = 0;
+		GLintptr idx_base = 0;
+		bool isRingUpload = g_UsePersistentMapping && !isShaderClipping && !isCompact && uploadToRing(draw_data, vtx_base, idx_base);
+		bool isMergedUpload = isRingUpload || g_UseMergedUpload || isShaderClipping || isCompact;
+		if (isRingUpload)
+		{
+			setupVertexAttribs(g_Ring.vboHandle);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_Ring.elementsHandle);
+		}
+		else if (isCompact)
+		{
+			// Already merged by mergeCompactDrawData
+			setupVertexAttribs(g_VboHandle, true);
+			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)g_CompactVtxStaging.Size * sizeof(CompactDrawVert), (const GLvoid*)g_CompactVtxStaging.Data, GL_STREAM_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)g_IdxStaging.Size * sizeof(ImDrawIdx), (const GLvoid*)g_IdxStaging.Data, GL_STREAM_DRAW);
+
+			if (isShaderClipping)
+			{
+				uploadClipRects(draw_data, fb_height, draw_data->FramebufferScale);
+				glEnableVertexAttribArray(g_AttribLocationClipRect);
+			}
+		}
+		else if (isMergedUpload)
+		{
+			// One upload for the whole frame
+			mergeDrawData(draw_data);
+			setupVertexAttribs(g_VboHandle);
+			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)g_VtxStaging.Size * sizeof(ImDrawVert), (const GLvoid*)g_VtxStaging.Data, GL_STREAM_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)g_IdxStaging.Size * sizeof(ImDrawIdx), (const GLvoid*)g_IdxStaging.Data, GL_STREAM_DRAW);
+
+			if (isShaderClipping)
+			{
+				uploadClipRects(draw_data, fb_height, draw_data->FramebufferScale);
+				glEnableVertexAttribArray(g_AttribLocationClipRect);
+			}
+		}
+		else
+		{
+			setupVertexAttribs(g_VboHandle);
+		}
+
+		BoundDrawState bound_state;
+		auto drawBatch = [&](const DrawBatch& batch)
+		{
+			if (bound_state.bindTexture(batch.textureId))
+			{
+				glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)batch.textureId);
+			}
+			// Clipped per fragment with shader clipping
+			const ImVec4 clip_rect = DrawBatch::scaleClipRect(batch.clipRect, draw_data->FramebufferScale);
+			if (!isShaderClipping && bound_state.bindClipRect(clip_rect))
+			{
+				glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+			}
+
+			// Lists share one buffer when merged and large lists have several vertex segments, draw them with a base vertex
+			glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)batch.elemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (const GLvoid*)(idx_base + batch.idxOffset * sizeof(ImDrawIdx)), vtx_base + (GLint)batch.vtxOffset);
+			g_Stats.drawCalls++;
 		};
-		glUseProgram(g_ShaderHandle);
-		glUniform1i(g_UniformLocationTex, 0);
-		glUniformMatrix4fv(g_UniformLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
-		glBindVertexArray(g_VaoHandle);
-		glBindSampler(0, 0); // Rely on combined texture/sampler state.
 
 		for (int n = 0; n < draw_data->CmdListsCount; n++)
 		{
 			const ImDrawList* cmd_list = draw_data->CmdLists[n];
-			const ImDrawIdx* idx_buffer_offset = 0;
+			if (!isMergedUpload)
+			{
+				glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+				glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
 
-			glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+			}
 
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+			// The clip rectangle does not end a batch when it is applied per fragment
+			drawListBatches(cmd_list, bound_state, drawBatch, !isShaderClipping);
+
+			if (isMergedUpload)
+			{
+				vtx_base += cmd_list->VtxBuffer.Size;
+				idx_base += cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+			}
+		}
+
+		if (isRingUpload)
+		{
+			// Mark the region as in use until the GPU is done with it
+			g_Ring.fences[g_Ring.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			g_Ring.region = (g_Ring.region + 1) % PersistentRing::kNumRegions;
+		}
+		if (isShaderClipping)
+		{
+			glDisableVertexAttribArray(g_AttribLocationClipRect);
+		}
+
+		// Restore modified GL state. The draw loop changed these bindings behind the shadow's back.
+		current_state.texture = -1;
+		current_state.arrayBuffer = -1;
+		current_state.elementArrayBuffer = -1;
+		current_state.scissorBox[2] = current_state.scissorBox[3] = -2;
+		g_Stats.glCallsAvoided += std::max(0, GLStateShadow::kNumRestoreCalls - GLStateShadow::apply(current_state, app_state));
 
+		ofBlendMode blend_mode = ofGetStyle().blendingMode;
+		if (g_UseOwnedState && blend_mode != OF_BLENDMODE_ALPHA && blend_mode != OF_BLENDMODE_DISABLED)
+		{
+			// Let openFrameworks put back the blend function that belongs to its blend mode
+			ofGetGLRenderer()->setBlendMode(blend_mode);
+		}
+
+		if (isGpuTiming)
+		{
+			g_GpuTimer.end();
+		}
+		addDrawTiming(start_micros);
+		Tracer::end();
+	}
+
+	//--------------------------------------------------------------
+	void GLStateShadow::query()
+	{
+		glGetIntegerv(GL_ACTIVE_TEXTURE, (GLint*)&activeTexture);
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+		glGetIntegerv(GL_SAMPLER_BINDING, &sampler);
+		glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+		glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementArrayBuffer);
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+		GLint polygon_mode[2]; glGetIntegerv(GL_POLYGON_MODE, polygon_mode);
+		polygonMode = polygon_mode[0];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glGetIntegerv(GL_SCISSOR_BOX, scissorBox);
+		glGetIntegerv(GL_BLEND_SRC_RGB, (GLint*)&blendSrcRgb);
+		glGetIntegerv(GL_BLEND_DST_RGB, (GLint*)&blendDstRgb);
+		glGetIntegerv(GL_BLEND_SRC_ALPHA, (GLint*)&blendSrcAlpha);
+		glGetIntegerv(GL_BLEND_DST_ALPHA, (GLint*)&blendDstAlpha);
+		glGetIntegerv(GL_BLEND_EQUATION_RGB, (GLint*)&blendEquationRgb);
+		glGetIntegerv(GL_BLEND_EQUATION_ALPHA, (GLint*)&blendEquationAlpha);
+		blend = glIsEnabled(GL_BLEND);
+		cullFace = glIsEnabled(GL_CULL_FACE);
+		depthTest = glIsEnabled(GL_DEPTH_TEST);
+		scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+	}
+
+	//--------------------------------------------------------------
+	void GLStateShadow::queryFromRenderer()
+	{
+		// openFrameworks caches the shader it has bound, so the program has to be exact
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+		// openFrameworks binds textures, buffers and vertex arrays before each of its draws
+		activeTexture = GL_TEXTURE0;
+		texture = 0;
+		sampler = 0;
+		arrayBuffer = 0;
+		elementArrayBuffer = 0;
+		vertexArray = 0;
+		polygonMode = GL_FILL;
+
+		ofRectangle nativeViewport = ofGetGLRenderer()->getNativeViewport();
+		viewport[0] = (GLint)nativeViewport.x;
+		viewport[1] = (GLint)nativeViewport.y;
+		viewport[2] = (GLint)nativeViewport.width;
+		viewport[3] = (GLint)nativeViewport.height;
+
+		// The shadow keeps the GUI blend function, which is also the one of OF_BLENDMODE_ALPHA
+		blend = ofGetStyle().blendingMode != OF_BLENDMODE_DISABLED;
+
+		// Not tracked by openFrameworks, e.g. ofEnableDepthTest() only once in setup(), so these are asked
+		cullFace = glIsEnabled(GL_CULL_FACE);
+		depthTest = glIsEnabled(GL_DEPTH_TEST);
+		scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+	}
+
+	//--------------------------------------------------------------
+	int GLStateShadow::apply(GLStateShadow& current, const GLStateShadow& target)
+	{
+		int calls = 0;
+		if (current.program != target.program) { glUseProgram(target.program); calls++; }
+
+		// Texture and sampler bindings refer to unit 0
+		if ((current.texture != target.texture || current.sampler != target.sampler) && current.activeTexture != GL_TEXTURE0)
+		{
+			glActiveTexture(GL_TEXTURE0);
+			current.activeTexture = GL_TEXTURE0;
+			calls++;
+		}
+		if (current.texture != target.texture) { glBindTexture(GL_TEXTURE_2D, target.texture); calls++; }
+		if (current.sampler != target.sampler) { glBindSampler(0, target.sampler); calls++; }
+		if (current.activeTexture != target.activeTexture) { glActiveTexture(target.activeTexture); calls++; }
+
+		if (current.vertexArray != target.vertexArray)
+		{
+			// The element array binding is part of the vertex array object
+			glBindVertexArray(target.vertexArray);
+			current.elementArrayBuffer = target.elementArrayBuffer;
+			calls++;
+		}
+		if (current.arrayBuffer != target.arrayBuffer) { glBindBuffer(GL_ARRAY_BUFFER, target.arrayBuffer); calls++; }
+		if (current.elementArrayBuffer != target.elementArrayBuffer) { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, target.elementArrayBuffer); calls++; }
+
+		if (current.blendEquationRgb != target.blendEquationRgb || current.blendEquationAlpha != target.blendEquationAlpha)
+		{
+			glBlendEquationSeparate(target.blendEquationRgb, target.blendEquationAlpha);
+			calls++;
+		}
+		if (current.blendSrcRgb != target.blendSrcRgb || current.blendDstRgb != target.blendDstRgb ||
+			current.blendSrcAlpha != target.blendSrcAlpha || current.blendDstAlpha != target.blendDstAlpha)
+		{
+			glBlendFuncSeparate(target.blendSrcRgb, target.blendDstRgb, target.blendSrcAlpha, target.blendDstAlpha);
+			calls++;
+		}
+		if (current.blend != target.blend) { if (target.blend) glEnable(GL_BLEND); else glDisable(GL_BLEND); calls++; }
+		if (current.cullFace != target.cullFace) { if (target.cullFace) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE); calls++; }
+		if (current.depthTest != target.depthTest) { if (target.depthTest) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST); calls++; }
+		if (current.scissorTest != target.scissorTest) { if (target.scissorTest) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST); calls++; }
+		if (current.polygonMode != target.polygonMode) { glPolygonMode(GL_FRONT_AND_BACK, target.polygonMode); calls++; }
+
+		if (memcmp(current.viewport, target.viewport, sizeof(viewport)) != 0)
+		{
+			glViewport(target.viewport[0], target.viewport[1], (GLsizei)target.viewport[2], (GLsizei)target.viewport[3]);
+			calls++;
+		}
+		if (target.scissorBox[2] >= 0 && memcmp(current.scissorBox, target.scissorBox, sizeof(scissorBox)) != 0)
+		{
+			glScissor(target.scissorBox[0], target.scissorBox[1], (GLsizei)target.scissorBox[2], (GLsizei)target.scissorBox[3]);
+			calls++;
+		}
+
+		current = target;
+		return calls;
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::setOwnedState(bool enabled)
+	{
+		g_UseOwnedState = enabled;
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::setShaderClipping(bool enabled)
+	{
+		g_UseShaderClipping = enabled;
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::setFixedBufferObjects(bool enabled)
+	{
+		g_UseFixedBufferObjects = enabled;
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::uploadClipRects(ImDrawData * draw_data, int fb_height, const ImVec2& scale)
+	{
+		// Vertices are never shared between draw commands, so each one gets the clip rectangle of its command
+		g_ClipStaging.resize(draw_data->TotalVtxCount);
+		ImVec4* clip_dst = g_ClipStaging.Data;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
 			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
 			{
 				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-				if (pcmd->UserCallback)
+				const ImVec4 scaled = DrawBatch::scaleClipRect(pcmd->ClipRect, scale);
+				const ImVec4 clip_rect((float)(int)scaled.x, (float)(int)(fb_height - scaled.w), (float)(int)scaled.z, (float)(int)(fb_height - scaled.y));
+				if (!pcmd->UserCallback)
 				{
-					pcmd->UserCallback(cmd_list, pcmd);
+					for (unsigned int i = 0; i < pcmd->ElemCount; i++)
+					{
+						clip_dst[pcmd->VtxOffset + idx_buffer[i]] = clip_rect;
+					}
 				}
-				else
-				{
-					glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-					glScissor((int)pcmd->ClipRect.x, (int)(fb_height - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-					glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
-				}
-				idx_buffer_offset += pcmd->ElemCount;
+				idx_buffer += pcmd->ElemCount;
 			}
+			clip_dst += cmd_list->VtxBuffer.Size;
 		}
 
-		// Restore modified GL state
-		glUseProgram(last_program);
-		glBindTexture(GL_TEXTURE_2D, last_texture);
-		glBindSampler(0, last_sampler);
-		glActiveTexture(last_active_texture);
-		glBindVertexArray(last_vertex_array);
-		glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, last_element_array_buffer);
-		glBlendEquationSeparate(last_blend_equation_rgb, last_blend_equation_alpha);
-		glBlendFuncSeparate(last_blend_src_rgb, last_blend_dst_rgb, last_blend_src_alpha, last_blend_dst_alpha);
-		if (last_enable_blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
-		if (last_enable_cull_face) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
-		if (last_enable_depth_test) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
-		if (last_enable_scissor_test) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST);
-		glPolygonMode(GL_FRONT_AND_BACK, last_polygon_mode[0]);
-		glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
-		glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+		glBindBuffer(GL_ARRAY_BUFFER, g_ClipVboHandle);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)g_ClipStaging.Size * sizeof(ImVec4), (const GLvoid*)g_ClipStaging.Data, GL_STREAM_DRAW);
+		glVertexAttribPointer(g_AttribLocationClipRect, 4, GL_FLOAT, GL_FALSE, sizeof(ImVec4), (GLvoid*)0);
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::setupVertexAttribs(GLuint vboHandle, bool compact)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, vboHandle);
+		if (compact)
+		{
+			glVertexAttribPointer(g_AttribLocationPosition, 2, GL_SHORT, GL_FALSE, sizeof(CompactDrawVert), (GLvoid*)IM_OFFSETOF(CompactDrawVert, pos));
+			glVertexAttribPointer(g_AttribLocationUV, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactDrawVert), (GLvoid*)IM_OFFSETOF(CompactDrawVert, uv));
+			glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactDrawVert), (GLvoid*)IM_OFFSETOF(CompactDrawVert, col));
+			return;
+		}
+		glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, pos));
+		glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, uv));
+		glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::setPersistentMapping(bool enabled)
+	{
+		if (enabled && !isPersistentMappingSupported())
+		{
+			ofLogWarning("EngineGLFW") << "Persistent mapping requires GL 4.4 or GL_ARB_buffer_storage, using glBufferData uploads";
+			enabled = false;
+		}
+		g_UsePersistentMapping = enabled;
+	}
+
+	//--------------------------------------------------------------
+	bool EngineGLFW::isPersistentMappingSupported()
+	{
+		if (!ofIsGLProgrammableRenderer() || glBufferStorage == nullptr || glFenceSync == nullptr)
+		{
+			return false;
+		}
+		auto renderer = ofGetGLRenderer();
+		bool isCore44 = renderer && (renderer->getGLVersionMajor() > 4 || (renderer->getGLVersionMajor() == 4 && renderer->getGLVersionMinor() >= 4));
+		return isCore44 || ofGLCheckExtension("GL_ARB_buffer_storage");
+	}
+
+	//--------------------------------------------------------------
+	bool EngineGLFW::reserveRing(GLsizeiptr vtxSize, GLsizeiptr idxSize)
+	{
+		g_Ring.vtxHighWater = std::max(g_Ring.vtxHighWater, vtxSize);
+		g_Ring.idxHighWater = std::max(g_Ring.idxHighWater, idxSize);
+		if (g_Ring.vboHandle && vtxSize <= g_Ring.vtxRegionSize && idxSize <= g_Ring.idxRegionSize)
+		{
+			return true;
+		}
+
+		destroyRing();
+
+		// Leave headroom above the high-water mark so a growing GUI does not reallocate every frame.
+		// Vertex regions stay a multiple of the vertex size so a region start is a valid base vertex.
+		GLsizeiptr vtxCount = (g_Ring.vtxHighWater / sizeof(ImDrawVert)) * 3 / 2 + 1024;
+		g_Ring.vtxRegionSize = vtxCount * sizeof(ImDrawVert);
+		g_Ring.idxRegionSize = ((g_Ring.idxHighWater / sizeof(ImDrawIdx)) * 3 / 2 + 3072) * sizeof(ImDrawIdx);
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLint last_copy_buffer; glGetIntegerv(GL_COPY_WRITE_BUFFER_BINDING, &last_copy_buffer);
+
+		glGenBuffers(1, &g_Ring.vboHandle);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, g_Ring.vboHandle);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, g_Ring.vtxRegionSize * PersistentRing::kNumRegions, nullptr, flags);
+		g_Ring.vtxData = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, g_Ring.vtxRegionSize * PersistentRing::kNumRegions, flags);
+
+		glGenBuffers(1, &g_Ring.elementsHandle);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, g_Ring.elementsHandle);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, g_Ring.idxRegionSize * PersistentRing::kNumRegions, nullptr, flags);
+		g_Ring.idxData = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, g_Ring.idxRegionSize * PersistentRing::kNumRegions, flags);
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, last_copy_buffer);
+
+		if (!g_Ring.vtxData || !g_Ring.idxData)
+		{
+			ofLogError("EngineGLFW") << "Could not map persistent buffers, using glBufferData uploads";
+			destroyRing();
+			g_UsePersistentMapping = false;
+			return false;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void EngineGLFW::destroyRing()
+	{
+		for (int i = 0; i < PersistentRing::kNumRegions; i++)
+		{
+			if (g_Ring.fences[i])
+			{
+				glClientWaitSync(g_Ring.fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000));
+				glDeleteSync(g_Ring.fences[i]);
+				g_Ring.fences[i] = 0;
+			}
+		}
+
+		// Deleting a buffer also unmaps it
+		if (g_Ring.vboHandle) glDeleteBuffers(1, &g_Ring.vboHandle);
+		if (g_Ring.elementsHandle) glDeleteBuffers(1, &g_Ring.elementsHandle);
+		g_Ring.vboHandle = g_Ring.elementsHandle = 0;
+		g_Ring.vtxData = g_Ring.idxData = nullptr;
+		g_Ring.vtxRegionSize = g_Ring.idxRegionSize = 0;
+		g_Ring.region = 0;
+	}
+
+	//--------------------------------------------------------------
+	bool EngineGLFW::uploadToRing(ImDrawData * draw_data, GLint& vtx_base, GLintptr& idx_base)
+	{
+		GLsizeiptr vtxSize = (GLsizeiptr)draw_data->TotalVtxCount * sizeof(ImDrawVert);
+		GLsizeiptr idxSize = (GLsizeiptr)draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+		if (!reserveRing(vtxSize, idxSize))
+		{
+			return false;
+		}
+
+		// Wait until the GPU has consumed what was written to this region kNumRegions frames ago
+		GLsync& fence = g_Ring.fences[g_Ring.region];
+		if (fence)
+		{
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			while (result == GL_TIMEOUT_EXPIRED)
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000));
+			}
+			glDeleteSync(fence);
+			fence = 0;
+		}
+
+		GLintptr vtxOffset = g_Ring.vtxRegionSize * g_Ring.region;
+		GLintptr idxOffset = g_Ring.idxRegionSize * g_Ring.region;
+		vtx_base = (GLint)(vtxOffset / sizeof(ImDrawVert));
+		idx_base = idxOffset;
+
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			memcpy(g_Ring.vtxData + vtxOffset, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+			memcpy(g_Ring.idxData + idxOffset, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+			vtxOffset += cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+			idxOffset += cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+		}
+		return true;
 	}
 
 	//--------------------------------------------------------------
 	void EngineGLFW::fixedDrawData(ImDrawData * draw_data)
 	{
 		// Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
-		ImGuiIO& io = ImGui::GetIO();
-		int fb_width = (int)(io.DisplaySize.x * io.DisplayFramebufferScale.x);
-		int fb_height = (int)(io.DisplaySize.y * io.DisplayFramebufferScale.y);
+		int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
 		if (fb_width == 0 || fb_height == 0)
 			return;
-		draw_data->ScaleClipRects(io.DisplayFramebufferScale);
+
+		g_Stats.resetCounters();
+		uint64_t start_micros = ofGetElapsedTimeMicros();
+		Tracer::begin("Draw");
+		bool isGpuTiming = g_UseTiming && g_GpuTimer.begin(g_Stats.timings.gpuDraw);
 
 		// We are using the OpenGL fixed pipeline to make the example code simpler to read!
 		// Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled, vertex/texcoord/color pointers, polygon fill.
@@ -273,9 +696,23 @@ namespace ofxImGui
 		GLint last_polygon_mode[2]; glGetIntegerv(GL_POLYGON_MODE, last_polygon_mode);
 		GLint last_viewport[4]; glGetIntegerv(GL_VIEWPORT, last_viewport);
 		GLint last_scissor_box[4]; glGetIntegerv(GL_SCISSOR_BOX, last_scissor_box);
+		GLint last_array_buffer = 0, last_element_array_buffer = 0;
+		bool isBufferUpload = g_UseFixedBufferObjects && g_VboHandle && g_ElementsHandle;
+		if (isBufferUpload)
+		{
+			glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+			glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &last_element_array_buffer);
+		}
 		glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TRANSFORM_BIT);
 		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		if (g_PremultipliedAlphaTarget)
+		{
+			glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
 		glDisable(GL_CULL_FACE);
 		glDisable(GL_DEPTH_TEST);
 		glEnable(GL_SCISSOR_TEST);
@@ -291,42 +728,81 @@ namespace ofxImGui
 		glMatrixMode(GL_PROJECTION);
 		glPushMatrix();
 		glLoadIdentity();
-		glOrtho(0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, -1.0f, +1.0f);
+		glOrtho(0.0f, draw_data->DisplaySize.x, draw_data->DisplaySize.y, 0.0f, -1.0f, +1.0f);
 		glMatrixMode(GL_MODELVIEW);
 		glPushMatrix();
 		glLoadIdentity();
 
+		// One upload for the frame. The fixed function path may not have base vertex draws, so while
+		// the frame fits ImDrawIdx the indices are rebased and the pointers are only set once.
+		bool isRebased = isBufferUpload && (int64_t)draw_data->TotalVtxCount <= (int64_t)std::numeric_limits<ImDrawIdx>::max() + 1;
+		if (isBufferUpload)
+		{
+			mergeDrawData(draw_data, isRebased);
+			glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)g_VtxStaging.Size * sizeof(ImDrawVert), (const GLvoid*)g_VtxStaging.Data, GL_STREAM_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)g_IdxStaging.Size * sizeof(ImDrawIdx), (const GLvoid*)g_IdxStaging.Data, GL_STREAM_DRAW);
+		}
+
+		// Vertex pointers currently set, each list and each vertex segment of a list needs its own unless rebased
+		const ImDrawVert* pointed_vtx_buffer = nullptr;
+
+		BoundDrawState bound_state;
+		const ImDrawVert* vtx_buffer = nullptr;
+		const ImDrawIdx* idx_buffer = nullptr;
+		auto drawBatch = [&](const DrawBatch& batch)
+		{
+			const ImDrawVert* batch_vtx_buffer = isRebased ? nullptr : vtx_buffer + batch.vtxOffset;
+			if (!bound_state.isValid() || batch_vtx_buffer != pointed_vtx_buffer)
+			{
+				glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)batch_vtx_buffer + IM_OFFSETOF(ImDrawVert, pos)));
+				glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)batch_vtx_buffer + IM_OFFSETOF(ImDrawVert, uv)));
+				glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert), (const GLvoid*)((const char*)batch_vtx_buffer + IM_OFFSETOF(ImDrawVert, col)));
+				pointed_vtx_buffer = batch_vtx_buffer;
+			}
+
+			if (bound_state.bindTexture(batch.textureId))
+			{
+				glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)batch.textureId);
+			}
+			const ImVec4 clip_rect = DrawBatch::scaleClipRect(batch.clipRect, draw_data->FramebufferScale);
+			if (bound_state.bindClipRect(clip_rect))
+			{
+				glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+			}
+
+			glDrawElements(GL_TRIANGLES, (GLsizei)batch.elemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer + batch.idxOffset);
+			g_Stats.drawCalls++;
+		};
+
 		// Render command lists
+		const ImDrawVert* list_vtx_offset = nullptr;   // into the buffer objects
+		const ImDrawIdx* list_idx_offset = nullptr;
 		for (int n = 0; n < draw_data->CmdListsCount; n++)
 		{
 			const ImDrawList* cmd_list = draw_data->CmdLists[n];
-			const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data;
-			const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
-			glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, pos)));
-			glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, uv)));
-			glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, col)));
-
-			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			vtx_buffer = cmd_list->VtxBuffer.Data;
+			idx_buffer = cmd_list->IdxBuffer.Data;
+			if (isBufferUpload)
 			{
-				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-				if (pcmd->UserCallback)
-				{
-					pcmd->UserCallback(cmd_list, pcmd);
-				}
-				else
-				{
-					glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-					glScissor((int)pcmd->ClipRect.x, (int)(fb_height - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-					glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer);
-				}
-				idx_buffer += pcmd->ElemCount;
+				vtx_buffer = list_vtx_offset;
+				idx_buffer = list_idx_offset;
+				list_vtx_offset += cmd_list->VtxBuffer.Size;
+				list_idx_offset += cmd_list->IdxBuffer.Size;
 			}
+			drawListBatches(cmd_list, bound_state, drawBatch);
 		}
 
 		// Restore modified state
 		glDisableClientState(GL_COLOR_ARRAY);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 		glDisableClientState(GL_VERTEX_ARRAY);
+		if (isBufferUpload)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, (GLuint)last_array_buffer);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)last_element_array_buffer);
+		}
 		glBindTexture(GL_TEXTURE_2D, (GLuint)last_texture);
 		glMatrixMode(GL_MODELVIEW);
 		glPopMatrix();
@@ -336,6 +812,13 @@ namespace ofxImGui
 		glPolygonMode(GL_FRONT, last_polygon_mode[0]); glPolygonMode(GL_BACK, last_polygon_mode[1]);
 		glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
 		glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+
+		if (isGpuTiming)
+		{
+			g_GpuTimer.end();
+		}
+		addDrawTiming(start_micros);
+		Tracer::end();
 	}
 
 	//--------------------------------------------------------------
@@ -375,6 +858,8 @@ namespace ofxImGui
 	{
 		if (ofIsGLProgrammableRenderer())
 		{
+			uint64_t phaseStart = ofGetElapsedTimeMicros();
+
 			// Backup GL state
 			GLint last_texture, last_array_buffer, last_vertex_array;
 			glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
@@ -407,25 +892,59 @@ namespace ofxImGui
 			"	Out_Color = Frag_Color * texture( Texture, Frag_UV.st);\n"
 			"}\n";
 
-			g_ShaderHandle = glCreateProgram();
-			g_VertHandle = glCreateShader(GL_VERTEX_SHADER);
-			g_FragHandle = glCreateShader(GL_FRAGMENT_SHADER);
-			glShaderSource(g_VertHandle, 1, &vertex_shader, 0);
-			glShaderSource(g_FragHandle, 1, &fragment_shader, 0);
-			glCompileShader(g_VertHandle);
-			glCompileShader(g_FragHandle);
-			glAttachShader(g_ShaderHandle, g_VertHandle);
-			glAttachShader(g_ShaderHandle, g_FragHandle);
-			glLinkProgram(g_ShaderHandle);
+			// Same shaders with the clip rectangle passed per vertex and tested per fragment
+			const GLchar *clip_vertex_shader =
+			"#version 150\n"
+			"uniform mat4 ProjMtx;\n"
+			"in vec2 Position;\n"
+			"in vec2 UV;\n"
+			"in vec4 Color;\n"
+			"in vec4 ClipRect;\n"
+			"out vec2 Frag_UV;\n"
+			"out vec4 Frag_Color;\n"
+			"flat out vec4 Frag_ClipRect;\n"
+			"void main()\n"
+			"{\n"
+			"	Frag_UV = UV;\n"
+			"	Frag_Color = Color;\n"
+			"	Frag_ClipRect = ClipRect;\n"
+			"	gl_Position = ProjMtx * vec4(Position.xy,0,1);\n"
+			"}\n";
 
-			g_UniformLocationTex = glGetUniformLocation(g_ShaderHandle, "Texture");
-			g_UniformLocationProjMtx = glGetUniformLocation(g_ShaderHandle, "ProjMtx");
-			g_AttribLocationPosition = glGetAttribLocation(g_ShaderHandle, "Position");
-			g_AttribLocationUV = glGetAttribLocation(g_ShaderHandle, "UV");
-			g_AttribLocationColor = glGetAttribLocation(g_ShaderHandle, "Color");
+			const GLchar* clip_fragment_shader =
+			"#version 150\n"
+			"uniform sampler2D Texture;\n"
+			"in vec2 Frag_UV;\n"
+			"in vec4 Frag_Color;\n"
+			"flat in vec4 Frag_ClipRect;\n"
+			"out vec4 Out_Color;\n"
+			"void main()\n"
+			"{\n"
+			"	if (any(lessThan(gl_FragCoord.xy, Frag_ClipRect.xy)) || any(greaterThanEqual(gl_FragCoord.xy, Frag_ClipRect.zw))) discard;\n"
+			"	Out_Color = Frag_Color * texture( Texture, Frag_UV.st);\n"
+			"}\n";
+
+			// Fixed attribute locations, so both programs can use the same vertex array
+			g_AttribLocationPosition = 0;
+			g_AttribLocationUV = 1;
+			g_AttribLocationColor = 2;
+			g_AttribLocationClipRect = 3;
+
+			ShaderCache::AttribLocations attrib_locations = {
+				{ g_AttribLocationPosition, "Position" },
+				{ g_AttribLocationUV, "UV" },
+				{ g_AttribLocationColor, "Color" }
+			};
+			g_ShaderHandle = ShaderCache::createProgram(vertex_shader, fragment_shader, attrib_locations);
+			attrib_locations.push_back({ g_AttribLocationClipRect, "ClipRect" });
+			g_ClipShaderHandle = ShaderCache::createProgram(clip_vertex_shader, clip_fragment_shader, attrib_locations);
+
+			addSetupTiming("shaders", phaseStart);
+			phaseStart = ofGetElapsedTimeMicros();
 
 			glGenBuffers(1, &g_VboHandle);
 			glGenBuffers(1, &g_ElementsHandle);
+			glGenBuffers(1, &g_ClipVboHandle);
 
 			glGenVertexArrays(1, &g_VaoHandle);
 			glBindVertexArray(g_VaoHandle);
@@ -438,8 +957,25 @@ namespace ofxImGui
 			glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, uv));
 			glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
 
+			addSetupTiming("buffers", phaseStart);
+			phaseStart = ofGetElapsedTimeMicros();
+
 			createFontsTexture();
 
+			addSetupTiming("fonts", phaseStart);
+			phaseStart = ofGetElapsedTimeMicros();
+
+			// Waited on last, a parallel compiler links both programs while the buffers and the font atlas are made
+			ShaderCache::finishProgram(g_ShaderHandle);
+			ShaderCache::finishProgram(g_ClipShaderHandle);
+
+			g_UniformLocationTex = glGetUniformLocation(g_ShaderHandle, "Texture");
+			g_UniformLocationProjMtx = glGetUniformLocation(g_ShaderHandle, "ProjMtx");
+			g_ClipUniformLocationTex = glGetUniformLocation(g_ClipShaderHandle, "Texture");
+			g_ClipUniformLocationProjMtx = glGetUniformLocation(g_ClipShaderHandle, "ProjMtx");
+
+			addSetupTiming("link", phaseStart);
+
 			// Restore modified GL state
 			glBindTexture(GL_TEXTURE_2D, last_texture);
 			glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
@@ -449,7 +985,13 @@ namespace ofxImGui
 		}
 		else
 		{
+			// Only used with setFixedBufferObjects()
+			glGenBuffers(1, &g_VboHandle);
+			glGenBuffers(1, &g_ElementsHandle);
+
+			uint64_t phaseStart = ofGetElapsedTimeMicros();
 			createFontsTexture();
+			addSetupTiming("fonts", phaseStart);
 
 			return true;
 		}
@@ -486,23 +1028,32 @@ namespace ofxImGui
 	//--------------------------------------------------------------
 	void EngineGLFW::invalidateDeviceObjects()
 	{
+		g_GpuTimer.exit();
+
 		if (ofIsGLProgrammableRenderer())
 		{
+			destroyRing();
+
 			if (g_VaoHandle) glDeleteVertexArrays(1, &g_VaoHandle);
 			if (g_VboHandle) glDeleteBuffers(1, &g_VboHandle);
 			if (g_ElementsHandle) glDeleteBuffers(1, &g_ElementsHandle);
 			g_VaoHandle = g_VboHandle = g_ElementsHandle = 0;
 
-			if (g_ShaderHandle && g_VertHandle) glDetachShader(g_ShaderHandle, g_VertHandle);
-			if (g_VertHandle) glDeleteShader(g_VertHandle);
-			g_VertHandle = 0;
-
-			if (g_ShaderHandle && g_FragHandle) glDetachShader(g_ShaderHandle, g_FragHandle);
-			if (g_FragHandle) glDeleteShader(g_FragHandle);
-			g_FragHandle = 0;
-
+			// The shaders were deleted by the ShaderCache once linked
 			if (g_ShaderHandle) glDeleteProgram(g_ShaderHandle);
 			g_ShaderHandle = 0;
+
+			if (g_ClipVboHandle) glDeleteBuffers(1, &g_ClipVboHandle);
+			g_ClipVboHandle = 0;
+
+			if (g_ClipShaderHandle) glDeleteProgram(g_ClipShaderHandle);
+			g_ClipShaderHandle = 0;
+		}
+		else
+		{
+			if (g_VboHandle) glDeleteBuffers(1, &g_VboHandle);
+			if (g_ElementsHandle) glDeleteBuffers(1, &g_ElementsHandle);
+			g_VboHandle = g_ElementsHandle = 0;
 		}
 
 		if (g_FontTexture)
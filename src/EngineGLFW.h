@@ -5,13 +5,72 @@
 #if !defined(TARGET_OPENGLES) && (!defined (OF_TARGET_API_VULKAN) )
 
 #include "BaseEngine.h"
+#include "GpuTimer.h"
 
 #include "ofEvents.h"
 #include "imgui.h"
 
 namespace ofxImGui
 {
-	class EngineGLFW 
+	// Immutable, persistently mapped vertex/index storage split into regions
+	// that are written in turn and guarded by fences (GL 4.4 / ARB_buffer_storage).
+	struct PersistentRing
+	{
+		static const int kNumRegions = 3;
+
+		GLuint vboHandle = 0;
+		GLuint elementsHandle = 0;
+		unsigned char* vtxData = nullptr;
+		unsigned char* idxData = nullptr;
+		GLsizeiptr vtxRegionSize = 0;
+		GLsizeiptr idxRegionSize = 0;
+		GLsizeiptr vtxHighWater = 0;
+		GLsizeiptr idxHighWater = 0;
+		GLsync fences[kNumRegions] = { 0 };
+		int region = 0;
+	};
+
+	// Shadow copy of the GL state touched by programmableDrawData, used to
+	// only issue the calls that actually change something.
+	struct GLStateShadow
+	{
+		static const int kNumQueries = 20;      // glGet calls made by query()
+		static const int kNumOwnedQueries = 4;  // and by queryFromRenderer()
+		static const int kNumSetupCalls = 12;   // calls needed to set up the GUI state without shadowing
+		static const int kNumRestoreCalls = 16; // calls needed to restore the app state without shadowing
+
+		GLenum activeTexture = GL_TEXTURE0;
+		GLint program = 0;
+		GLint texture = 0;
+		GLint sampler = 0;
+		GLint arrayBuffer = 0;
+		GLint elementArrayBuffer = 0;
+		GLint vertexArray = 0;
+		GLint polygonMode = GL_FILL;
+		GLint viewport[4] = { 0, 0, 0, 0 };
+		GLint scissorBox[4] = { 0, 0, -1, -1 };    // negative size: value does not matter
+		GLenum blendSrcRgb = GL_SRC_ALPHA;
+		GLenum blendDstRgb = GL_ONE_MINUS_SRC_ALPHA;
+		GLenum blendSrcAlpha = GL_SRC_ALPHA;
+		GLenum blendDstAlpha = GL_ONE_MINUS_SRC_ALPHA;
+		GLenum blendEquationRgb = GL_FUNC_ADD;
+		GLenum blendEquationAlpha = GL_FUNC_ADD;
+		bool blend = false;
+		bool cullFace = false;
+		bool depthTest = false;
+		bool scissorTest = false;
+
+		// Read back the complete state from GL
+		void query();
+
+		// Derive the state from what openFrameworks' renderer keeps track of
+		void queryFromRenderer();
+
+		// Issue the calls needed to go from current to target, returns the number of calls made
+		static int apply(GLStateShadow& current, const GLStateShadow& target);
+	};
+
+	class EngineGLFW
 		: public BaseEngine
 	{
 	public:
@@ -26,7 +85,7 @@ namespace ofxImGui
 		bool createDeviceObjects() override;
 		void invalidateDeviceObjects() override;
 
-		void draw() override;
+		void drawData(ImDrawData * draw_data) override;
 
 		bool createFontsTexture();
 
@@ -39,7 +98,47 @@ namespace ofxImGui
 		static void programmableDrawData(ImDrawData * draw_data);
 		static void fixedDrawData(ImDrawData * draw_data);
 
+		// Upload vertices through persistently mapped buffers instead of glBufferData.
+		// Falls back to glBufferData when buffer storage is not available.
+		static void setPersistentMapping(bool enabled);
+		static bool isPersistentMappingSupported();
+
+		// Skip the full glGet backup of the app's GL state. Object bindings are reset to 0,
+		// blending, viewport and program are restored from what openFrameworks tracks. Depth test,
+		// face culling and scissor test are still queried, openFrameworks does not track them.
+		static void setOwnedState(bool enabled);
+
+		// Enforce clip rectangles in the fragment shader instead of with glScissor, so
+		// commands that only differ in their clip rectangle are drawn with one call.
+		// Uses the merged upload path.
+		static void setShaderClipping(bool enabled);
+
+		// Draw from buffer objects instead of client-side arrays in the fixed function path.
+		// The frame is uploaded once, with its indices rebased onto the merged vertex buffer.
+		static void setFixedBufferObjects(bool enabled);
+
 		static GLuint g_FontTexture;
+
+		static bool g_UsePersistentMapping;
+		static bool g_UseOwnedState;
+		static bool g_UseShaderClipping;
+		static bool g_UseFixedBufferObjects;
+		static PersistentRing g_Ring;
+		static GpuTimer g_GpuTimer;
+
+		static GLuint g_ClipShaderHandle;
+		static GLuint g_ClipVboHandle;
+		static GLint g_ClipUniformLocationTex;
+		static GLint g_ClipUniformLocationProjMtx;
+		static GLint g_AttribLocationClipRect;
+		static ImVector<ImVec4> g_ClipStaging;
+
+	private:
+		static void setupVertexAttribs(GLuint vboHandle, bool compact = false);
+		static void uploadClipRects(ImDrawData * draw_data, int fb_height, const ImVec2& scale);
+		static bool reserveRing(GLsizeiptr vtxSize, GLsizeiptr idxSize);
+		static void destroyRing();
+		static bool uploadToRing(ImDrawData * draw_data, GLint& vtx_base, GLintptr& idx_base);
 	};
 }
 
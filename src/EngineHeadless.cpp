@@ -0,0 +1,151 @@
+#include "EngineHeadless.h"
+
+#include "ofUtils.h"
+
+#include <cctype>
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	void EngineHeadless::setup(bool autoDraw)
+	{
+		if (isSetup) return;
+
+		setupTimings.clear();
+		uint64_t setupStart = ofGetElapsedTimeMicros();
+
+		ImGuiIO& io = ImGui::GetIO();
+
+		io.KeyMap[ImGuiKey_Tab] = OF_KEY_TAB;
+		io.KeyMap[ImGuiKey_LeftArrow] = OF_KEY_LEFT;
+		io.KeyMap[ImGuiKey_RightArrow] = OF_KEY_RIGHT;
+		io.KeyMap[ImGuiKey_UpArrow] = OF_KEY_UP;
+		io.KeyMap[ImGuiKey_DownArrow] = OF_KEY_DOWN;
+		io.KeyMap[ImGuiKey_PageUp] = OF_KEY_PAGE_UP;
+		io.KeyMap[ImGuiKey_PageDown] = OF_KEY_PAGE_DOWN;
+		io.KeyMap[ImGuiKey_Home] = OF_KEY_HOME;
+		io.KeyMap[ImGuiKey_End] = OF_KEY_END;
+		io.KeyMap[ImGuiKey_Delete] = OF_KEY_DEL;
+		io.KeyMap[ImGuiKey_Backspace] = OF_KEY_BACKSPACE;
+		io.KeyMap[ImGuiKey_Enter] = OF_KEY_RETURN;
+		io.KeyMap[ImGuiKey_Escape] = OF_KEY_ESC;
+
+		if (autoDraw)
+		{
+			io.RenderDrawListsFn = renderDrawLists;
+		}
+
+		io.SetClipboardTextFn = &BaseEngine::setClipboardString;
+		io.GetClipboardTextFn = &BaseEngine::getClipboardString;
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+		createDeviceObjects();
+
+		// Override listeners
+		ofAddListener(ofEvents().keyReleased, this, &EngineHeadless::onKeyReleased);
+		ofAddListener(ofEvents().keyPressed, this, &EngineHeadless::onKeyPressed);
+
+		// BaseEngine listeners
+		ofAddListener(ofEvents().mouseDragged, (BaseEngine*)this, &BaseEngine::onMouseDragged);
+		ofAddListener(ofEvents().mousePressed, (BaseEngine*)this, &BaseEngine::onMousePressed);
+		ofAddListener(ofEvents().mouseReleased, (BaseEngine*)this, &BaseEngine::onMouseReleased);
+		ofAddListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
+		ofAddListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		addInputTracking();
+
+		addSetupTiming("total", setupStart);
+
+		isSetup = true;
+	}
+
+	//--------------------------------------------------------------
+	void EngineHeadless::exit()
+	{
+		if (!isSetup) return;
+
+		// Override listeners
+		ofRemoveListener(ofEvents().keyReleased, this, &EngineHeadless::onKeyReleased);
+		ofRemoveListener(ofEvents().keyPressed, this, &EngineHeadless::onKeyPressed);
+
+		// BaseEngine listeners
+		ofRemoveListener(ofEvents().mouseDragged, (BaseEngine*)this, &BaseEngine::onMouseDragged);
+		ofRemoveListener(ofEvents().mousePressed, (BaseEngine*)this, &BaseEngine::onMousePressed);
+		ofRemoveListener(ofEvents().mouseReleased, (BaseEngine*)this, &BaseEngine::onMouseReleased);
+		ofRemoveListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
+		ofRemoveListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		removeInputTracking();
+
+		invalidateDeviceObjects();
+
+		isSetup = false;
+	}
+
+	//--------------------------------------------------------------
+	bool EngineHeadless::createDeviceObjects()
+	{
+		uint64_t phaseStart = ofGetElapsedTimeMicros();
+
+		// The atlas is built even when nothing samples it, it is part of the startup cost being measured
+		ImGuiIO& io = ImGui::GetIO();
+		unsigned char* pixels;
+		int width, height;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+		io.Fonts->TexID = (void *)(intptr_t)loadTextureImage2D(pixels, width, height);
+
+		addSetupTiming("fonts", phaseStart);
+
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void EngineHeadless::invalidateDeviceObjects()
+	{
+		ImGuiIO& io = ImGui::GetIO();
+		if (io.Fonts->TexID)
+		{
+			deleteTexture((GLuint)(intptr_t)io.Fonts->TexID);
+			io.Fonts->TexID = nullptr;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void EngineHeadless::onKeyPressed(ofKeyEventArgs& event)
+	{
+		setKeyDown(event.key, true);
+	}
+
+	//--------------------------------------------------------------
+	void EngineHeadless::onKeyReleased(ofKeyEventArgs& event)
+	{
+		setKeyDown(event.key, false);
+		ImGui::GetIO().AddInputCharacter((unsigned short)event.codepoint);
+	}
+
+	//--------------------------------------------------------------
+	void EngineHeadless::setKeyDown(int key, bool down)
+	{
+		// Modifier keys are past the end of KeysDown and only set the modifier flags
+		ImGuiIO& io = ImGui::GetIO();
+		if (key >= 0 && key < IM_ARRAYSIZE(io.KeysDown))
+		{
+			// Released letters can come with another case than they were pressed with
+			io.KeysDown[key < 128 ? tolower(key) : key] = down;
+		}
+		else if (key & OF_KEY_CONTROL)
+		{
+			io.KeyCtrl = down;
+		}
+		else if (key & OF_KEY_ALT)
+		{
+			io.KeyAlt = down;
+		}
+		else if (key & OF_KEY_SHIFT)
+		{
+			io.KeyShift = down;
+		}
+		else if (key & OF_KEY_SUPER)
+		{
+			io.KeySuper = down;
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BaseEngine.h"
+
+#include "ofEvents.h"
+#include "imgui.h"
+
+namespace ofxImGui
+{
+	// Setup, input and font atlas shared by the engines that run without a graphics context,
+	// EngineNull and EngineSoftware. They only differ in how they draw and keep textures.
+	class EngineHeadless
+		: public BaseEngine
+	{
+	public:
+		// BaseEngine required
+		void setup(bool autoDraw) override;
+		void exit() override;
+		bool createDeviceObjects() override;
+		void invalidateDeviceObjects() override;
+
+		// Key state is indexed by event.key, which means the same on every window, unlike the
+		// window specific keycode
+		void onKeyPressed(ofKeyEventArgs& event) override;
+		void onKeyReleased(ofKeyEventArgs& event) override;
+
+	protected:
+		// renderDrawLists is set as io.RenderDrawListsFn when drawing automatically
+		EngineHeadless(void (*renderDrawLists_)(ImDrawData * draw_data))
+			: renderDrawLists(renderDrawLists_)
+		{}
+
+	private:
+		static void setKeyDown(int key, bool down);
+
+		void (*renderDrawLists)(ImDrawData * draw_data);
+	};
+}
@@ -0,0 +1,103 @@
+#include "EngineNull.h"
+
+#include "ofAppRunner.h"
+#include "ofUtils.h"
+#include "Tracer.h"
+
+#include <limits>
+
+namespace ofxImGui
+{
+	NullEngineRecording EngineNull::g_Recording;
+	GLuint EngineNull::g_NextTextureId = 1;
+
+	//--------------------------------------------------------------
+	void EngineNull::drawData(ImDrawData * draw_data)
+	{
+		recordDrawData(draw_data);
+	}
+
+	//--------------------------------------------------------------
+	void EngineNull::recordDrawData(ImDrawData * draw_data)
+	{
+		g_Stats.resetCounters();
+		if (!draw_data || !draw_data->Valid)
+		{
+			return;
+		}
+
+		uint64_t start = ofGetElapsedTimeMicros();
+		Tracer::begin("Draw");
+
+		// Stage the buffers like an upload would, that is most of the CPU side cost of a backend
+		mergeDrawData(draw_data, draw_data->TotalVtxCount <= (int)std::numeric_limits<ImDrawIdx>::max() + 1);
+
+		ImTextureID last_texture = nullptr;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			DrawBatch batch;
+			unsigned int idx_offset = 0;
+
+			g_Recording.vertices += cmd_list->VtxBuffer.Size;
+			g_Recording.indices += cmd_list->IdxBuffer.Size;
+
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+				g_Recording.drawCommands++;
+				if (pcmd->UserCallback)
+				{
+					// Callbacks are recorded, not called, they would expect a graphics context
+					g_Recording.userCallbacks++;
+					batch.clear();
+				}
+				else if (batch.merge(pcmd, idx_offset))
+				{
+					g_Stats.mergedDrawCalls++;
+				}
+				else if (!DrawBatch::isClipRectEmpty(pcmd->ClipRect))
+				{
+					batch.reset(pcmd, idx_offset);
+					if (batch.textureId != last_texture)
+					{
+						g_Recording.textureSwitches++;
+						last_texture = batch.textureId;
+					}
+					g_Stats.drawCalls++;
+				}
+				idx_offset += pcmd->ElemCount;
+			}
+		}
+
+		g_Recording.drawCalls += g_Stats.drawCalls;
+		g_Recording.frames++;
+		g_Recording.lastFrameMicros = ofGetElapsedTimeMicros() - start;
+		g_Recording.totalMicros += g_Recording.lastFrameMicros;
+		addDrawTiming(start);
+		Tracer::end();
+	}
+
+	//--------------------------------------------------------------
+	const NullEngineRecording& EngineNull::getRecording()
+	{
+		return g_Recording;
+	}
+
+	//--------------------------------------------------------------
+	void EngineNull::resetRecording()
+	{
+		g_Recording = NullEngineRecording();
+	}
+
+	//--------------------------------------------------------------
+	GLuint EngineNull::loadTextureImage2D(unsigned char * pixels, int width, int height)
+	{
+		return g_NextTextureId++;
+	}
+
+	//--------------------------------------------------------------
+	void EngineNull::deleteTexture(GLuint texture)
+	{
+	}
+}
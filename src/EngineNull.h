@@ -0,0 +1,55 @@
+#pragma once
+
+#include "EngineHeadless.h"
+
+#include "ofEvents.h"
+#include "imgui.h"
+
+namespace ofxImGui
+{
+	// What EngineNull saw since the last resetRecording()
+	struct NullEngineRecording
+	{
+		unsigned int frames = 0;
+		unsigned int vertices = 0;
+		unsigned int indices = 0;
+		unsigned int drawCommands = 0;
+		unsigned int drawCalls = 0;         // after merging commands like the other backends do
+		unsigned int textureSwitches = 0;
+		unsigned int userCallbacks = 0;
+		uint64_t lastFrameMicros = 0;       // time spent consuming the last frame
+		uint64_t totalMicros = 0;
+	};
+
+	// Consumes the draw data without any graphics API, for measuring the CPU cost of a GUI
+	// on hosts without a GPU. Selected with Gui::setHeadless() or by defining OFXIMGUI_ENGINE_NULL.
+	class EngineNull
+		: public EngineHeadless
+	{
+	public:
+		EngineNull()
+			: EngineHeadless(recordDrawData)
+		{}
+
+		~EngineNull()
+		{
+			exit();
+		}
+
+		void drawData(ImDrawData * draw_data) override;
+
+		// Hands out ids without creating textures
+		GLuint loadTextureImage2D(unsigned char * pixels, int width, int height) override;
+		void deleteTexture(GLuint texture) override;
+
+		// Custom
+		static void recordDrawData(ImDrawData * draw_data);
+
+		static const NullEngineRecording& getRecording();
+		static void resetRecording();
+
+	private:
+		static NullEngineRecording g_Recording;
+		static GLuint g_NextTextureId;
+	};
+}
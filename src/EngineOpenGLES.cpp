@@ -4,16 +4,63 @@
 
 #include "ofAppRunner.h"
 #include "ofGLProgrammableRenderer.h"
+#include "ofGLUtils.h"
+#include "ShaderCache.h"
+#include "Tracer.h"
+
+#include <limits>
+
+#if !defined(TARGET_OF_IOS)
+#include <EGL/egl.h>
+#endif
+
+// Not declared by the ES 2 headers, resolved at runtime
+#ifndef GL_VERTEX_ARRAY_BINDING
+#define GL_VERTEX_ARRAY_BINDING 0x85B5
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+
+namespace
+{
+	typedef void (GL_APIENTRY *GenVertexArraysFn)(GLsizei n, GLuint* arrays);
+	typedef void (GL_APIENTRY *BindVertexArrayFn)(GLuint array);
+	typedef void (GL_APIENTRY *DeleteVertexArraysFn)(GLsizei n, const GLuint* arrays);
+	typedef void* (GL_APIENTRY *MapBufferRangeFn)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+	typedef GLboolean (GL_APIENTRY *UnmapBufferFn)(GLenum target);
+
+	GenVertexArraysFn genVertexArrays = nullptr;
+	BindVertexArrayFn bindVertexArray = nullptr;
+	DeleteVertexArraysFn deleteVertexArrays = nullptr;
+	MapBufferRangeFn mapBufferRange = nullptr;
+	UnmapBufferFn unmapBuffer = nullptr;
+
+	const GLsizeiptr kMinStreamCapacity = 64 * 1024;
+	const int kStreamFrames = 4;    // frames that fit in an append buffer before it wraps around
+}
 
 namespace ofxImGui
 {
-	ofShader EngineOpenGLES::g_Shader;
+	bool EngineOpenGLES::g_UseVertexArrays = false;
+	StreamingMode EngineOpenGLES::g_StreamingMode = STREAMING_ORPHAN;
+
+	StreamBuffer EngineOpenGLES::g_VtxStream;
+	StreamBuffer EngineOpenGLES::g_IdxStream;
+	GpuTimer EngineOpenGLES::g_GpuTimer;
+	GLintptr EngineOpenGLES::g_VaoVtxOffset = 0;
+	bool EngineOpenGLES::g_VaoCompactVertices = false;
 
 	//--------------------------------------------------------------
 	void EngineOpenGLES::setup(bool autoDraw)
 	{
 		if (isSetup) return;
 
+		setupTimings.clear();
+		uint64_t setupStart = ofGetElapsedTimeMicros();
+
 		ImGuiIO& io = ImGui::GetIO();
 
 		io.KeyMap[ImGuiKey_Tab] = OF_KEY_TAB;
@@ -37,6 +84,7 @@ namespace ofxImGui
 		
 		io.SetClipboardTextFn = &BaseEngine::setClipboardString;
 		io.GetClipboardTextFn = &BaseEngine::getClipboardString;
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
 
 		createDeviceObjects();
 
@@ -50,6 +98,9 @@ namespace ofxImGui
 		ofAddListener(ofEvents().mouseReleased, (BaseEngine*)this, &BaseEngine::onMouseReleased);
 		ofAddListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
 		ofAddListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		addInputTracking();
+
+		addSetupTiming("total", setupStart);
 
 		isSetup = true;
 	}
@@ -69,14 +120,18 @@ namespace ofxImGui
 		ofRemoveListener(ofEvents().mouseReleased, (BaseEngine*)this, &BaseEngine::onMouseReleased);
 		ofRemoveListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
 		ofRemoveListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		removeInputTracking();
 
 		invalidateDeviceObjects();
 
 		isSetup = false;
 	}
 
+	//--------------------------------------------------------------
 	bool EngineOpenGLES::createDeviceObjects()
 	{
+		uint64_t phaseStart = ofGetElapsedTimeMicros();
+
 //#if defined(TARGET_RASPBERRY_PI)
 //		std::string header = "";
 //#else
@@ -117,26 +172,54 @@ namespace ofxImGui
     )";
 
 
-		g_Shader.setupShaderFromSource(GL_FRAGMENT_SHADER, fragment_shader);
-		g_Shader.setupShaderFromSource(GL_VERTEX_SHADER, vertex_shader);
+		g_AttribLocationPosition = 0;
+		g_AttribLocationUV = 1;
+		g_AttribLocationColor = 2;
 
-		g_Shader.linkProgram();
+		g_ShaderHandle = ShaderCache::createProgram(vertex_shader, fragment_shader, {
+			{ g_AttribLocationPosition, "Position" },
+			{ g_AttribLocationUV, "UV" },
+			{ g_AttribLocationColor, "Color" }
+		});
 
 		// Backup GL state
 		GLint last_texture, last_array_buffer;
 		glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
 		glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
 
-		g_ShaderHandle = g_Shader.getProgram();
-
-		g_UniformLocationTex = glGetUniformLocation(g_ShaderHandle, "Texture");
-		g_UniformLocationProjMtx = glGetUniformLocation(g_ShaderHandle, "ProjMat");
-		g_AttribLocationPosition = glGetAttribLocation(g_ShaderHandle, "Position");
-		g_AttribLocationUV = glGetAttribLocation(g_ShaderHandle, "UV");
-		g_AttribLocationColor = glGetAttribLocation(g_ShaderHandle, "Color");
+		addSetupTiming("shaders", phaseStart);
+		phaseStart = ofGetElapsedTimeMicros();
 
 		glGenBuffers(1, &g_VboHandle);
 		glGenBuffers(1, &g_ElementsHandle);
+		g_VtxStream = StreamBuffer();
+		g_IdxStream = StreamBuffer();
+
+		// Appending needs unsynchronized mapping, otherwise every frame orphans its buffers
+		g_StreamingMode = loadMapBufferFunctions() ? STREAMING_APPEND : STREAMING_ORPHAN;
+
+		// The VAO keeps the attribute setup and the element buffer binding
+		g_UseVertexArrays = loadVertexArrayFunctions();
+		if (g_UseVertexArrays)
+		{
+			GLint last_vertex_array;
+			glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
+
+			genVertexArrays(1, &g_VaoHandle);
+			bindVertexArray(g_VaoHandle);
+			glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+			glEnableVertexAttribArray(g_AttribLocationPosition);
+			glEnableVertexAttribArray(g_AttribLocationUV);
+			glEnableVertexAttribArray(g_AttribLocationColor);
+			setupVertexAttribs(0, false);
+			g_VaoVtxOffset = 0;
+			g_VaoCompactVertices = false;
+			bindVertexArray(last_vertex_array);
+		}
+
+		addSetupTiming("buffers", phaseStart);
+		phaseStart = ofGetElapsedTimeMicros();
 
 		ImGuiIO& io = ImGui::GetIO();
 
@@ -182,106 +265,306 @@ namespace ofxImGui
 		glBindTexture(GL_TEXTURE_2D, last_texture);
 		glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
 
+		addSetupTiming("fonts", phaseStart);
+		phaseStart = ofGetElapsedTimeMicros();
+
+		// Waited on last, a parallel compiler links the program while the buffers and the font atlas are made
+		ShaderCache::finishProgram(g_ShaderHandle);
+
+		g_UniformLocationTex = glGetUniformLocation(g_ShaderHandle, "Texture");
+		g_UniformLocationProjMtx = glGetUniformLocation(g_ShaderHandle, "ProjMat");
+
+		addSetupTiming("link", phaseStart);
+
 		return true;
 	}
 
 	//--------------------------------------------------------------
 	void EngineOpenGLES::invalidateDeviceObjects()
 	{
+		g_GpuTimer.exit();
+
+		if (g_VaoHandle && deleteVertexArrays) deleteVertexArrays(1, &g_VaoHandle);
+		g_VaoHandle = 0;
 		if (g_VboHandle) glDeleteBuffers(1, &g_VboHandle);
 		if (g_ElementsHandle) glDeleteBuffers(1, &g_ElementsHandle);
 		g_VboHandle = g_ElementsHandle = 0;
 
-		g_Shader.unload();
+		if (g_ShaderHandle) glDeleteProgram(g_ShaderHandle);
 		g_ShaderHandle = 0;
 	}
 
 	//--------------------------------------------------------------
-	void EngineOpenGLES::draw()
+	void EngineOpenGLES::drawData(ImDrawData * draw_data)
 	{
-		rendererDrawData(ImGui::GetDrawData());
+		rendererDrawData(draw_data);
 	}
 
 	//--------------------------------------------------------------
 	void EngineOpenGLES::rendererDrawData(ImDrawData * draw_data)
 	{
+		g_Stats.resetCounters();
+		if (draw_data->TotalVtxCount == 0)
+		{
+			return;
+		}
+		uint64_t start_micros = ofGetElapsedTimeMicros();
+		Tracer::begin("Draw");
+		bool isGpuTiming = g_UseTiming && g_GpuTimer.begin(g_Stats.timings.gpuDraw);
+
 		GLint last_program, last_texture, last_array_buffer, last_element_array_buffer;
+		GLint last_vertex_array = 0;
 		glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
 		glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
 		glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
 		glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &last_element_array_buffer);
+		if (g_UseVertexArrays)
+		{
+			glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
+		}
 
 		// Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled
 		glEnable(GL_BLEND);
 		glBlendEquation(GL_FUNC_ADD);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		if (g_PremultipliedAlphaTarget)
+		{
+			glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
 		glDisable(GL_CULL_FACE);
 		glDisable(GL_DEPTH_TEST);
 		glEnable(GL_SCISSOR_TEST);
 		glActiveTexture(GL_TEXTURE0);
 
-		float width = ofGetWidth();
-		float height = ofGetHeight();
+		// From the draw data, the window may be resized by another thread while this one draws
+		float width = draw_data->DisplaySize.x;
+		float height = draw_data->DisplaySize.y;
+
+		// One upload for the whole frame. While the indices fit ImDrawIdx they are rebased onto the
+		// merged vertex buffer, so all lists share one attribute setup (ES 2 has no base vertex draws).
+		bool isRebased = (int64_t)draw_data->TotalVtxCount <= (int64_t)std::numeric_limits<ImDrawIdx>::max() + 1;
+		bool isCompact = g_UseCompactVertices && mergeCompactDrawData(draw_data, isRebased);
+		if (!isCompact)
+		{
+			mergeDrawData(draw_data, isRebased);
+		}
 
-		// Setup orthographic projection matrix
+		// Setup orthographic projection matrix, compact positions are scaled back to pixels
+		const float pos_scale = isCompact ? 1.0f / CompactDrawVert::kPosScale : 1.0f;
 		const float ortho_projection[4][4] =
 		{
-			{ 2.0f / width,           0.0f,                   0.0f, 0.0f },
-			{ 0.0f,                  2.0f / -height,           0.0f, 0.0f },
-			{ 0.0f,                  0.0f,                  -1.0f, 0.0f },
-			{-1.0f,                  1.0f,                   0.0f, 1.0f },
+			{ 2.0f * pos_scale / width, 0.0f,                       0.0f, 0.0f },
+			{ 0.0f,                     2.0f * pos_scale / -height, 0.0f, 0.0f },
+			{ 0.0f,                     0.0f,                      -1.0f, 0.0f },
+			{-1.0f,                     1.0f,                       0.0f, 1.0f },
 		};
 		glUseProgram(g_ShaderHandle);
 		glUniform1i(g_UniformLocationTex, 0);
 		glUniformMatrix4fv(g_UniformLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
 
 		// Render command lists
-		glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-		glEnableVertexAttribArray(g_AttribLocationPosition);
-		glEnableVertexAttribArray(g_AttribLocationUV);
-		glEnableVertexAttribArray(g_AttribLocationColor);
+		if (g_UseVertexArrays)
+		{
+			bindVertexArray(g_VaoHandle);
+			glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+		}
+		else
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+			glEnableVertexAttribArray(g_AttribLocationPosition);
+			glEnableVertexAttribArray(g_AttribLocationUV);
+			glEnableVertexAttribArray(g_AttribLocationColor);
+		}
 
-		glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)OFFSETOF(ImDrawVert, pos));
-		glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)OFFSETOF(ImDrawVert, uv));
-		glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)OFFSETOF(ImDrawVert, col));
+		const size_t vtx_stride = isCompact ? sizeof(CompactDrawVert) : sizeof(ImDrawVert);
+		GLintptr vtx_base = isCompact
+			? streamData(GL_ARRAY_BUFFER, g_VtxStream, g_CompactVtxStaging.Data, (GLsizeiptr)g_CompactVtxStaging.Size * sizeof(CompactDrawVert))
+			: streamData(GL_ARRAY_BUFFER, g_VtxStream, g_VtxStaging.Data, (GLsizeiptr)g_VtxStaging.Size * sizeof(ImDrawVert));
+		GLintptr idx_base = streamData(GL_ELEMENT_ARRAY_BUFFER, g_IdxStream, g_IdxStaging.Data, (GLsizeiptr)g_IdxStaging.Size * sizeof(ImDrawIdx));
 
-		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		auto pointAttribsAt = [&](GLintptr vtx_offset)
 		{
-			const ImDrawList* cmd_list = draw_data->CmdLists[n];
-			const ImDrawIdx* idx_buffer_offset = 0;
-
-			glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.size() * sizeof(ImDrawVert), (GLvoid*)&cmd_list->VtxBuffer.front(), GL_STREAM_DRAW);
+			if (g_UseVertexArrays && vtx_offset == g_VaoVtxOffset && isCompact == g_VaoCompactVertices)
+			{
+				g_Stats.glCallsAvoided += 3;
+				return;
+			}
+			setupVertexAttribs(vtx_offset, isCompact);
+			g_VaoVtxOffset = vtx_offset;
+			g_VaoCompactVertices = isCompact;
+		};
+		if (isRebased)
+		{
+			pointAttribsAt(vtx_base);
+		}
 
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.size() * sizeof(ImDrawIdx), (GLvoid*)&cmd_list->IdxBuffer.front(), GL_STREAM_DRAW);
+		BoundDrawState bound_state;
+		GLintptr vtx_list_offset = vtx_base;
+		GLintptr idx_list_offset = idx_base;
+		auto drawBatch = [&](const DrawBatch& batch)
+		{
+			if (!isRebased)
+			{
+				// Lists and the vertex segments of large lists each start at their own offset
+				pointAttribsAt(vtx_list_offset + batch.vtxOffset * vtx_stride);
+			}
 
-			for (const ImDrawCmd* pcmd = cmd_list->CmdBuffer.begin(); pcmd != cmd_list->CmdBuffer.end(); pcmd++)
+			if (bound_state.bindTexture(batch.textureId))
+			{
+				glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)batch.textureId);
+			}
+			const ImVec4& clip_rect = batch.clipRect;
+			if (bound_state.bindClipRect(clip_rect))
 			{
-				if (pcmd->UserCallback)
-				{
-					pcmd->UserCallback(cmd_list, pcmd);
-				}
-				else
-				{
-					glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-					glScissor((int)pcmd->ClipRect.x, (int)(height - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-					glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, GL_UNSIGNED_SHORT, idx_buffer_offset);
-
-				}
-				idx_buffer_offset += pcmd->ElemCount;
+				glScissor((int)clip_rect.x, (int)(height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
 			}
+
+			glDrawElements(GL_TRIANGLES, (GLsizei)batch.elemCount, GL_UNSIGNED_SHORT, (const GLvoid*)(idx_list_offset + batch.idxOffset * sizeof(ImDrawIdx)));
+			g_Stats.drawCalls++;
+		};
+
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			drawListBatches(cmd_list, bound_state, drawBatch);
+
+			vtx_list_offset += cmd_list->VtxBuffer.Size * vtx_stride;
+			idx_list_offset += cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
 		}
 
 		// Restore modified state
-		glDisableVertexAttribArray(g_AttribLocationPosition);
-		glDisableVertexAttribArray(g_AttribLocationUV);
-		glDisableVertexAttribArray(g_AttribLocationColor);
+		if (g_UseVertexArrays)
+		{
+			bindVertexArray(last_vertex_array);
+		}
+		else
+		{
+			glDisableVertexAttribArray(g_AttribLocationPosition);
+			glDisableVertexAttribArray(g_AttribLocationUV);
+			glDisableVertexAttribArray(g_AttribLocationColor);
+		}
 		glUseProgram(last_program);
 		glBindTexture(GL_TEXTURE_2D, last_texture);
 		glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, last_element_array_buffer);
 		glDisable(GL_SCISSOR_TEST);
+
+		if (isGpuTiming)
+		{
+			g_GpuTimer.end();
+		}
+		addDrawTiming(start_micros);
+		Tracer::end();
+	}
+
+	//--------------------------------------------------------------
+	void EngineOpenGLES::setupVertexAttribs(GLintptr vtx_offset, bool compact)
+	{
+		if (compact)
+		{
+			glVertexAttribPointer(g_AttribLocationPosition, 2, GL_SHORT, GL_FALSE, sizeof(CompactDrawVert), (GLvoid*)(vtx_offset + OFFSETOF(CompactDrawVert, pos)));
+			glVertexAttribPointer(g_AttribLocationUV, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactDrawVert), (GLvoid*)(vtx_offset + OFFSETOF(CompactDrawVert, uv)));
+			glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactDrawVert), (GLvoid*)(vtx_offset + OFFSETOF(CompactDrawVert, col)));
+			return;
+		}
+		glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)(vtx_offset + OFFSETOF(ImDrawVert, pos)));
+		glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)(vtx_offset + OFFSETOF(ImDrawVert, uv)));
+		glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)(vtx_offset + OFFSETOF(ImDrawVert, col)));
+	}
+
+	//--------------------------------------------------------------
+	GLintptr EngineOpenGLES::streamData(GLenum target, StreamBuffer& stream, const void* data, GLsizeiptr size)
+	{
+		if (g_StreamingMode == STREAMING_APPEND)
+		{
+			if (stream.offset + size > stream.capacity)
+			{
+				// Wrapping around: orphan, so frames still in flight keep the old storage
+				stream.capacity = std::max(stream.capacity, std::max(size * kStreamFrames, kMinStreamCapacity));
+				glBufferData(target, stream.capacity, nullptr, GL_STREAM_DRAW);
+				stream.offset = 0;
+			}
+
+			// Nothing in flight uses this range, so the write does not need to synchronize
+			GLintptr offset = stream.offset;
+			void* dst = mapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+			if (dst)
+			{
+				memcpy(dst, data, size);
+				unmapBuffer(target);
+			}
+			else
+			{
+				glBufferSubData(target, offset, size, data);
+			}
+			stream.offset = (offset + size + 15) & ~(GLintptr)15;
+			return offset;
+		}
+
+		// Orphan the previous storage, keeping the size so the driver can recycle it
+		if (size > stream.capacity)
+		{
+			stream.capacity = std::max(size + size / 2, kMinStreamCapacity);
+		}
+		glBufferData(target, stream.capacity, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(target, 0, size, data);
+		return 0;
+	}
+
+	//--------------------------------------------------------------
+	bool EngineOpenGLES::loadVertexArrayFunctions()
+	{
+#if defined(TARGET_OF_IOS)
+		if (ofGLCheckExtension("GL_OES_vertex_array_object"))
+		{
+			genVertexArrays = glGenVertexArraysOES;
+			bindVertexArray = glBindVertexArrayOES;
+			deleteVertexArrays = glDeleteVertexArraysOES;
+		}
+#else
+		std::string suffix;
+		if (ofGetGLESVersion() >= 3)
+		{
+			suffix = "";
+		}
+		else if (ofGLCheckExtension("GL_OES_vertex_array_object"))
+		{
+			suffix = "OES";
+		}
+		else
+		{
+			return false;
+		}
+		genVertexArrays = (GenVertexArraysFn)eglGetProcAddress(("glGenVertexArrays" + suffix).c_str());
+		bindVertexArray = (BindVertexArrayFn)eglGetProcAddress(("glBindVertexArray" + suffix).c_str());
+		deleteVertexArrays = (DeleteVertexArraysFn)eglGetProcAddress(("glDeleteVertexArrays" + suffix).c_str());
+#endif
+		return genVertexArrays && bindVertexArray && deleteVertexArrays;
+	}
+
+	//--------------------------------------------------------------
+	bool EngineOpenGLES::loadMapBufferFunctions()
+	{
+#if defined(TARGET_OF_IOS) || defined(TARGET_EMSCRIPTEN)
+		// No unsynchronized mapping in these contexts
+		return false;
+#else
+		if (ofGetGLESVersion() >= 3)
+		{
+			mapBufferRange = (MapBufferRangeFn)eglGetProcAddress("glMapBufferRange");
+			unmapBuffer = (UnmapBufferFn)eglGetProcAddress("glUnmapBuffer");
+		}
+		else if (ofGLCheckExtension("GL_EXT_map_buffer_range") && ofGLCheckExtension("GL_OES_mapbuffer"))
+		{
+			mapBufferRange = (MapBufferRangeFn)eglGetProcAddress("glMapBufferRangeEXT");
+			unmapBuffer = (UnmapBufferFn)eglGetProcAddress("glUnmapBufferOES");
+		}
+		return mapBufferRange && unmapBuffer;
+#endif
 	}
 
 	//--------------------------------------------------------------
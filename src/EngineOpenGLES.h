@@ -4,13 +4,27 @@
 #if defined(TARGET_OPENGLES) && (!defined (OF_TARGET_API_VULKAN) )
 
 #include "BaseEngine.h"
+#include "GpuTimer.h"
 
 #include "ofEvents.h"
-#include "ofShader.h"
 #include "imgui.h"
 
 namespace ofxImGui
 {
+	// How vertices and indices are streamed to their buffer objects
+	enum StreamingMode
+	{
+		STREAMING_ORPHAN,   // respecify the whole buffer every frame
+		STREAMING_APPEND    // write behind the previous frame, orphan only when wrapping around
+	};
+
+	// A buffer object that is written to every frame
+	struct StreamBuffer
+	{
+		GLsizeiptr capacity = 0;
+		GLintptr offset = 0;
+	};
+
 	class EngineOpenGLES 
 		: public BaseEngine
 	{
@@ -26,14 +40,28 @@ namespace ofxImGui
 		bool createDeviceObjects() override;
 		void invalidateDeviceObjects() override;
 
-		void draw() override;
+		void drawData(ImDrawData * draw_data) override;
 
 		void onKeyReleased(ofKeyEventArgs& event) override;
 
 		// Custom 
 		static void rendererDrawData(ImDrawData * draw_data);
 
-		static ofShader g_Shader;
+		// Picked by createDeviceObjects from what the context supports
+		static bool g_UseVertexArrays;
+		static StreamingMode g_StreamingMode;
+		static GpuTimer g_GpuTimer;
+
+	private:
+		static bool loadVertexArrayFunctions();
+		static bool loadMapBufferFunctions();
+		static void setupVertexAttribs(GLintptr vtx_offset, bool compact);
+		static GLintptr streamData(GLenum target, StreamBuffer& stream, const void* data, GLsizeiptr size);
+
+		static StreamBuffer g_VtxStream;
+		static StreamBuffer g_IdxStream;
+		static GLintptr g_VaoVtxOffset;     // vertex offset the attribute pointers stored in the VAO point at
+		static bool g_VaoCompactVertices;   // and whether they describe CompactDrawVert
 	};
 }
 
@@ -0,0 +1,94 @@
+#include "EngineSoftware.h"
+
+#include "ofAppRunner.h"
+#include "ofUtils.h"
+#include "Tracer.h"
+
+namespace ofxImGui
+{
+	SoftwareRasterizer EngineSoftware::g_Rasterizer;
+	ofPixels EngineSoftware::g_Pixels;
+	ofColor EngineSoftware::g_ClearColor(0, 0, 0, 0);
+	GLuint EngineSoftware::g_NextTextureId = 1;
+
+	//--------------------------------------------------------------
+	void EngineSoftware::drawData(ImDrawData * draw_data)
+	{
+		rasterizeDrawData(draw_data);
+	}
+
+	//--------------------------------------------------------------
+	void EngineSoftware::rasterizeDrawData(ImDrawData * draw_data)
+	{
+		g_Stats.resetCounters();
+		if (!draw_data || !draw_data->Valid)
+		{
+			return;
+		}
+
+		int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+		if (fb_width <= 0 || fb_height <= 0)
+		{
+			return;
+		}
+		uint64_t start_micros = ofGetElapsedTimeMicros();
+		Tracer::begin("Draw");
+
+		if ((int)g_Pixels.getWidth() != fb_width || (int)g_Pixels.getHeight() != fb_height || g_Pixels.getNumChannels() != 4)
+		{
+			g_Pixels.allocate(fb_width, fb_height, OF_PIXELS_RGBA);
+		}
+		g_Pixels.setColor(g_ClearColor);
+
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				// Callbacks expect a graphics context, they are skipped
+				if (!cmd_list->CmdBuffer[cmd_i].UserCallback)
+				{
+					g_Stats.drawCalls++;
+				}
+			}
+		}
+
+		g_Rasterizer.setPremultipliedAlpha(g_PremultipliedAlphaTarget);
+		g_Rasterizer.render(draw_data, g_Pixels.getData(), fb_width, fb_height, draw_data->FramebufferScale);
+		addDrawTiming(start_micros);
+		Tracer::end();
+	}
+
+	//--------------------------------------------------------------
+	const ofPixels& EngineSoftware::getPixels()
+	{
+		return g_Pixels;
+	}
+
+	//--------------------------------------------------------------
+	void EngineSoftware::setClearColor(const ofColor& color)
+	{
+		g_ClearColor = color;
+	}
+
+	//--------------------------------------------------------------
+	void EngineSoftware::setThreadCount(int count)
+	{
+		g_Rasterizer.setThreadCount(count);
+	}
+
+	//--------------------------------------------------------------
+	GLuint EngineSoftware::loadTextureImage2D(unsigned char * pixels, int width, int height)
+	{
+		GLuint id = g_NextTextureId++;
+		g_Rasterizer.setTexture((ImTextureID)(intptr_t)id, pixels, width, height);
+		return id;
+	}
+
+	//--------------------------------------------------------------
+	void EngineSoftware::deleteTexture(GLuint texture)
+	{
+		g_Rasterizer.removeTexture((ImTextureID)(intptr_t)texture);
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EngineHeadless.h"
+#include "SoftwareRasterizer.h"
+
+#include "ofColor.h"
+#include "ofEvents.h"
+#include "ofPixels.h"
+#include "imgui.h"
+
+namespace ofxImGui
+{
+	// Renders the GUI on the CPU into an ofPixels buffer the size of the framebuffer, for screenshots
+	// and pixel comparisons on hosts without a GPU. Selected with Gui::setHeadless(true, true).
+	class EngineSoftware
+		: public EngineHeadless
+	{
+	public:
+		EngineSoftware()
+			: EngineHeadless(rasterizeDrawData)
+		{}
+
+		~EngineSoftware()
+		{
+			exit();
+		}
+
+		void drawData(ImDrawData * draw_data) override;
+
+		// Keeps a copy of the RGBA pixels for the rasterizer
+		GLuint loadTextureImage2D(unsigned char * pixels, int width, int height) override;
+		void deleteTexture(GLuint texture) override;
+
+		// Custom
+		static void rasterizeDrawData(ImDrawData * draw_data);
+
+		// The last frame, RGBA
+		static const ofPixels& getPixels();
+
+		// Each frame starts from this color, transparent by default
+		static void setClearColor(const ofColor& color);
+
+		// Threads rendering tiles, 0 uses all cores
+		static void setThreadCount(int count);
+
+	private:
+		static SoftwareRasterizer g_Rasterizer;
+		static ofPixels g_Pixels;
+		static ofColor g_ClearColor;
+		static GLuint g_NextTextureId;
+	};
+}
@@ -10,7 +10,12 @@
 #include "vk/RenderBatch.h"
 #include "vk/Shader.h"
 #include "vk/DrawCommand.h"
+#include "EngineVkShaders.h"
+#include "Tracer.h"
+#include "ofFileUtils.h"
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <cstring>
 
 // We keep a shared pointer to the renderer so we don't have to 
 // fetch it anew every time we need it.
@@ -20,12 +25,22 @@ namespace ofxImGui
 {
 
 	::of::vk::RenderBatch*                  EngineVk::batch = nullptr; // current renderbatch
-	std::unique_ptr<of::vk::ImageAllocator> EngineVk::mImageAllocator;
 	std::shared_ptr<of::vk::Texture>        EngineVk::mFontTexture;    // wrapper with sampler around font texture
 	std::shared_ptr<::vk::Image>            EngineVk::mFontImage;      // data store for image data
 	::vk::Device                            EngineVk::mDevice;         // non-owning reference to vk device
 
 	std::unique_ptr<of::vk::DrawCommand>    EngineVk::mDrawCommand;    // draw command prototype
+	std::unique_ptr<of::vk::DrawCommand>    EngineVk::mCompactDrawCommand;
+
+	std::unordered_map<ImTextureID, EngineVk::TextureDrawCommand> EngineVk::mTextureDrawCommands;
+	uint64_t                                EngineVk::mFrameIndex = 0;
+	uint64_t                                EngineVk::mFontReadyFrame = 0;
+	std::vector<EngineVk::ImageAllocatorBlock> EngineVk::mImageAllocators;
+	std::vector<EngineVk::RetiredTexture>   EngineVk::mRetiredTextures;
+	std::string                             EngineVk::mPipelineCacheFile;
+
+	// Room for alignment when estimating the image memory an upload needs
+	static const ::vk::DeviceSize kImageAlignmentSlack = 1 << 16;
 
 	void EngineVk::setRenderBatch( of::vk::RenderBatch & batch_ ){
 		batch = &batch_;
@@ -37,10 +52,14 @@ namespace ofxImGui
 	{
 		if (isSetup) return;
 
+		setupTimings.clear();
+		uint64_t setupStart = ofGetElapsedTimeMicros();
+
 		mRenderer = dynamic_pointer_cast<ofVkRenderer>( ofGetCurrentRenderer() );
 		mDevice  = mRenderer->getVkDevice();
 
 		setupImageAllocator();
+		loadPipelineCache();
 
 		ImGuiIO& io = ImGui::GetIO();
 
@@ -68,6 +87,7 @@ namespace ofxImGui
 
 		io.SetClipboardTextFn = &BaseEngine::setClipboardString;
 		io.GetClipboardTextFn = &BaseEngine::getClipboardString;
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
 
 		createDeviceObjects();
 
@@ -81,6 +101,9 @@ namespace ofxImGui
 		ofAddListener(ofEvents().mouseReleased, (BaseEngine*)this, &BaseEngine::onMouseReleased);
 		ofAddListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
 		ofAddListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		addInputTracking();
+
+		addSetupTiming("total", setupStart);
 
 		isSetup = true;
 
@@ -88,25 +111,114 @@ namespace ofxImGui
 	
 	//--------------------------------------------------------------
 
-	void EngineVk::setupImageAllocator(){
+	void EngineVk::setupImageAllocator( ::vk::DeviceSize size ){
 
 		const auto & rendererProperties = mRenderer->getVkRendererProperties();
 
 		{
 				of::vk::ImageAllocator::Settings allocatorSettings;
 				allocatorSettings.device = mDevice;
-				allocatorSettings.size = ( 1 << 24UL ); // 16 MB
+				allocatorSettings.size = size; // 16 MB for the first one
 				allocatorSettings.memFlags = ::vk::MemoryPropertyFlagBits::eDeviceLocal;
 				allocatorSettings.physicalDeviceMemoryProperties = rendererProperties.physicalDeviceMemoryProperties;
 				allocatorSettings.physicalDeviceProperties = rendererProperties.physicalDeviceProperties;
 
-				mImageAllocator = std::make_unique<of::vk::ImageAllocator>( allocatorSettings );
-				mImageAllocator->setup();
+				ImageAllocatorBlock block;
+				block.allocator = std::make_unique<of::vk::ImageAllocator>( allocatorSettings );
+				block.allocator->setup();
+				block.size = size;
+				mImageAllocators.push_back( std::move( block ) );
+		}
+	}
+
+	//--------------------------------------------------------------
+
+	void EngineVk::setPipelineCacheFile( const std::string& path ){
+		mPipelineCacheFile = path;
+	}
+
+	//--------------------------------------------------------------
+
+	void EngineVk::loadPipelineCache(){
+
+		if ( mPipelineCacheFile.empty() ){
+			return;
+		}
+
+		ofBuffer buffer = ofBufferFromFile( mPipelineCacheFile, true );
+		if ( buffer.size() < 4 * sizeof( uint32_t ) + VK_UUID_SIZE ){
+			return;
+		}
+
+		// VK_PIPELINE_CACHE_HEADER_VERSION_ONE: header length, version, vendor id, device id, cache uuid
+		const auto & deviceProperties = mRenderer->getVkRendererProperties().physicalDeviceProperties;
+		uint32_t header[4];
+		memcpy( header, buffer.getData(), sizeof( header ) );
+		if ( header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			|| header[2] != deviceProperties.vendorID
+			|| header[3] != deviceProperties.deviceID
+			|| memcmp( buffer.getData() + sizeof( header ), &deviceProperties.pipelineCacheUUID[0], VK_UUID_SIZE ) != 0 ){
+			ofLogVerbose( "EngineVk" ) << "Ignoring pipeline cache of another device or driver";
+			return;
+		}
+
+		// Merged into the renderer's cache, which the GUI pipeline is created from
+		auto pipelineCache = mDevice.createPipelineCache( ::vk::PipelineCacheCreateInfo( {}, buffer.size(), buffer.getData() ) );
+		mDevice.mergePipelineCaches( *mRenderer->getPipelineCache(), { pipelineCache } );
+		mDevice.destroyPipelineCache( pipelineCache );
+	}
+
+	//--------------------------------------------------------------
+
+	void EngineVk::storePipelineCache(){
+
+		if ( mPipelineCacheFile.empty() ){
+			return;
+		}
+
+		auto data = mDevice.getPipelineCacheData( *mRenderer->getPipelineCache() );
+		if ( data.empty() ){
+			return;
+		}
+
+		ofBuffer buffer( reinterpret_cast<const char*>( data.data() ), data.size() );
+		if ( !ofBufferToFile( mPipelineCacheFile, buffer, true ) ){
+			ofLogWarning( "EngineVk" ) << "Could not write pipeline cache " << mPipelineCacheFile;
 		}
 	}
 
 	//--------------------------------------------------------------
 
+	const std::unique_ptr<of::vk::ImageAllocator>& EngineVk::reserveImageMemory( ::vk::DeviceSize size, ImageAllocatorBlock*& block ){
+
+		// Allocators whose images are all gone can start over
+		for ( auto & b : mImageAllocators ){
+			b.images.erase( std::remove_if( b.images.begin(), b.images.end(), []( const std::weak_ptr<::vk::Image>& image ){
+				return image.expired();
+			} ), b.images.end() );
+			if ( b.images.empty() && b.used > 0 ){
+				b.allocator->reset();
+				b.used = 0;
+			}
+		}
+
+		for ( auto & b : mImageAllocators ){
+			if ( b.used + size <= b.size ){
+				b.used += size;
+				block = &b;
+				return b.allocator;
+			}
+		}
+
+		// Grow instead of failing the upload
+		setupImageAllocator( std::max( mImageAllocators.empty() ? 0 : mImageAllocators.back().size * 2, size ) );
+		block = &mImageAllocators.back();
+		block->used += size;
+		return block->allocator;
+	}
+
+	//--------------------------------------------------------------
+
 	void EngineVk::exit()
 	{
 		if (!isSetup) return;
@@ -121,7 +233,9 @@ namespace ofxImGui
 		ofRemoveListener(ofEvents().mouseReleased, (BaseEngine*)this, &BaseEngine::onMouseReleased);
 		ofRemoveListener(ofEvents().mouseScrolled, (BaseEngine*)this, &BaseEngine::onMouseScrolled);
 		ofRemoveListener(ofEvents().windowResized, (BaseEngine*)this, &BaseEngine::onWindowResized);
+		removeInputTracking();
 
+		storePipelineCache();
 		invalidateDeviceObjects();
 
 		isSetup = false;
@@ -161,6 +275,7 @@ namespace ofxImGui
 		{
 			remapToGLFWConvention(button);
 			mousePressed[button] = true;
+			mouseLatched[button] = true;
 			mouseReleased = false;
 		}
 	}
@@ -170,61 +285,181 @@ namespace ofxImGui
 	void EngineVk::render(ImDrawData * draw_data)
 	{
 		// Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
-		ImGuiIO& io = ImGui::GetIO();
-		int fb_width = (int)(io.DisplaySize.x * io.DisplayFramebufferScale.x);
-		int fb_height = (int)(io.DisplaySize.y * io.DisplayFramebufferScale.y);
+		int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
 		if (fb_width == 0 || fb_height == 0)
 			return;
-		draw_data->ScaleClipRects(io.DisplayFramebufferScale);
+
+		g_Stats.resetCounters();
+		uint64_t start_micros = ofGetElapsedTimeMicros();
+		Tracer::begin("Draw");
 
 		auto & alloc = batch->getContext()->getTransientAllocator();
 
 		::vk::DeviceSize offset = 0;
 		void * dataP = nullptr;
 
+		// Compact positions arrive as snorm, the projection scales them back to pixels
+		bool isCompact = g_UseCompactVertices && mergeCompactDrawData( draw_data );
+		const float pos_scale = isCompact ? 32767.0f / CompactDrawVert::kPosScale : 1.0f;
 		const glm::mat4 ortho_projection =
 		{
-			{ 2.0f / io.DisplaySize.x, 0.0f,                    0.0f, 0.0f },
-			{ 0.0f,                    2.0f / io.DisplaySize.y, 0.0f, 0.0f },
-			{ 0.0f,                    0.0f,                    1.0f, 0.0f },
-			{ -1.f,                    -1.f,                    0.0f, 1.0f },
+			{ 2.0f * pos_scale / draw_data->DisplaySize.x, 0.0f,                                         0.0f, 0.0f },
+			{ 0.0f,                                         2.0f * pos_scale / draw_data->DisplaySize.y, 0.0f, 0.0f },
+			{ 0.0f,                                         0.0f,                                         1.0f, 0.0f },
+			{ -1.f,                                         -1.f,                                         0.0f, 1.0f },
 		};
 
-		// create a 
-		auto dc = *mDrawCommand;
+		mFrameIndex++;
+		releaseRetiredTextures();
 
-		dc.setUniform( "modelViewProjectionMatrix", ortho_projection );
+		// One transient allocation for the whole frame: all vertices, followed by all indices.
+		// Lists are addressed through firstIndex and vertexOffset of each draw.
+		::vk::DeviceSize vtx_size = draw_data->TotalVtxCount * ( isCompact ? sizeof( CompactDrawVert ) : sizeof( ImDrawVert ) );
+		::vk::DeviceSize idx_start = ( vtx_size + sizeof( ImDrawIdx ) - 1 ) & ~::vk::DeviceSize( sizeof( ImDrawIdx ) - 1 );
+		::vk::DeviceSize idx_size = draw_data->TotalIdxCount * sizeof( ImDrawIdx );
+		if ( vtx_size == 0 || !alloc.allocate( idx_start + idx_size, offset ) || !alloc.map( dataP ) ){
+			Tracer::end();
+			return;
+		}
 
-		for ( int n = 0; n < draw_data->CmdListsCount; n++ ){
-			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+		if ( isCompact ){
+			memcpy( dataP, g_CompactVtxStaging.Data, vtx_size );
+			memcpy( static_cast<char*>( dataP ) + idx_start, g_IdxStaging.Data, idx_size );
+		} else{
+			ImDrawVert* vtx_dst = reinterpret_cast<ImDrawVert*>( dataP );
+			ImDrawIdx* idx_dst = reinterpret_cast<ImDrawIdx*>( static_cast<char*>( dataP ) + idx_start );
+			for ( int n = 0; n < draw_data->CmdListsCount; n++ ){
+				const ImDrawList* cmd_list = draw_data->CmdLists[n];
+				memcpy( vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof( ImDrawVert ) );
+				memcpy( idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof( ImDrawIdx ) );
+				vtx_dst += cmd_list->VtxBuffer.Size;
+				idx_dst += cmd_list->IdxBuffer.Size;
+			}
+		}
+		const int format = isCompact ? VERTEX_FORMAT_COMPACT : VERTEX_FORMAT_FULL;
+
+		// Draw command of the bound texture, the scissor is part of it
+		BoundDrawState bound_state;
+		of::vk::DrawCommand* dc = nullptr;
+
+		uint32_t list_vtx_offset = 0;
+		uint32_t list_idx_offset = 0;
 
-			dc.allocAndSetAttribute( 0, (void*)cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof( ImDrawVert ), alloc );
-			dc.allocAndSetIndices(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof( ImDrawIdx ), alloc );
-			
-			for ( int cmd_i = 0, idx_offset = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++ ){
-				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-				if ( pcmd->UserCallback ){
-					pcmd->UserCallback( cmd_list, pcmd );
-				} else{
-
-					// Set texture from texture id stored with ImGui draw command
-					
-					dc.setTexture( "tex_unit_0", *( static_cast<of::vk::Texture*>( pcmd->TextureId ) ) );
-
-					//VkRect2D scissor;
-					//scissor.offset.x = (int32_t)( pcmd->ClipRect.x ) > 0 ? (int32_t)( pcmd->ClipRect.x ) : 0;
-					//scissor.offset.y = (int32_t)( pcmd->ClipRect.y ) > 0 ? (int32_t)( pcmd->ClipRect.y ) : 0;
-					//scissor.extent.width = (uint32_t)( pcmd->ClipRect.z - pcmd->ClipRect.x );
-					//scissor.extent.height = (uint32_t)( pcmd->ClipRect.w - pcmd->ClipRect.y + 1 ); // FIXME: Why +1 here?
-					//vkCmdSetScissor( g_CommandBuffer, 0, 1, &scissor );
-
-					batch->draw( dc, pcmd->ElemCount, 1, idx_offset, 0, 0 );
+		auto drawBatch = [&]( const DrawBatch& pending ){
+			if ( !isTextureReady( pending.textureId ) ){
+				return;
+			}
+
+			// Each texture keeps its own draw command, so switching textures does not rebuild descriptors
+			if ( bound_state.bindTexture( pending.textureId ) ){
+				auto & entry = getTextureDrawCommand( pending.textureId, format );
+				size_t slot = mFrameIndex % kFramesInFlight;
+				dc = entry.dcs[format][slot].get();
+				if ( entry.preparedFrames[format][slot] != mFrameIndex ){
+					dc->setUniform( "modelViewProjectionMatrix", ortho_projection );
+					dc->setAttribute( 0, alloc.getBuffer(), offset );
+					dc->setIndices( alloc.getBuffer(), offset + idx_start );
+					entry.preparedFrames[format][slot] = mFrameIndex;
 				}
+				bound_state.invalidateClipRect();
+			}
 
-				idx_offset += pcmd->ElemCount;
+			// Scissor is dynamic pipeline state, the offset must not be negative
+			const ImVec4 clip_rect = DrawBatch::scaleClipRect( pending.clipRect, draw_data->FramebufferScale );
+			if ( bound_state.bindClipRect( clip_rect ) ){
+				::vk::Rect2D scissor;
+				scissor.offset.x = std::max( (int32_t)clip_rect.x, 0 );
+				scissor.offset.y = std::max( (int32_t)clip_rect.y, 0 );
+				scissor.extent.width = (uint32_t)std::max( (int32_t)clip_rect.z - scissor.offset.x, 0 );
+				scissor.extent.height = (uint32_t)std::max( (int32_t)clip_rect.w - scissor.offset.y, 0 );
+				dc->setScissor( scissor );
 			}
+
+			batch->draw( *dc, pending.elemCount, 1, list_idx_offset + pending.idxOffset, list_vtx_offset + (int32_t)pending.vtxOffset, 0 );
+			g_Stats.drawCalls++;
+		};
+
+		for ( int n = 0; n < draw_data->CmdListsCount; n++ ){
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			drawListBatches( cmd_list, bound_state, drawBatch );
+
+			list_vtx_offset += cmd_list->VtxBuffer.Size;
+			list_idx_offset += cmd_list->IdxBuffer.Size;
+		}
+
+		evictUnusedTextures();
+
+		// The batch records its command buffer after this returns, so there is no GPU timing to bracket the draws with
+		addDrawTiming( start_micros );
+		Tracer::end();
+	}
+
+	//--------------------------------------------------------------
+
+	EngineVk::TextureDrawCommand& EngineVk::getTextureDrawCommand( ImTextureID textureId, int format )
+	{
+		// Frames in flight may still read the draw command of the previous frames, so each gets its own
+		auto & entry = mTextureDrawCommands[textureId];
+		auto & dc = entry.dcs[format][mFrameIndex % kFramesInFlight];
+		if ( !dc ){
+			dc = std::make_unique<of::vk::DrawCommand>( format == VERTEX_FORMAT_COMPACT ? *mCompactDrawCommand : *mDrawCommand );
+			dc->setTexture( "tex_unit_0", *static_cast<of::vk::Texture*>( textureId ) );
+		}
+		entry.lastUsedFrame = mFrameIndex;
+		return entry;
+	}
+
+	//--------------------------------------------------------------
+
+	bool EngineVk::isTextureReady( ImTextureID textureId )
+	{
+		return textureId && ( textureId != mFontTexture.get() || mFrameIndex >= mFontReadyFrame );
+	}
+
+	//--------------------------------------------------------------
+
+	void EngineVk::releaseRetiredTextures()
+	{
+		mRetiredTextures.erase( std::remove_if( mRetiredTextures.begin(), mRetiredTextures.end(), []( const RetiredTexture& retired ){
+			return mFrameIndex >= retired.releaseFrame;
+		} ), mRetiredTextures.end() );
+	}
+
+	//--------------------------------------------------------------
+
+	void EngineVk::releaseTexture( ImTextureID textureId )
+	{
+		retireTexture( textureId, nullptr, nullptr );
+	}
+
+	//--------------------------------------------------------------
+
+	void EngineVk::retireTexture( ImTextureID textureId, std::shared_ptr<::vk::Image> image, std::shared_ptr<of::vk::Texture> texture )
+	{
+		// Batches of the frames in flight still reference the descriptors of the draw commands
+		RetiredTexture retired{ std::move( image ), std::move( texture ), mFrameIndex + kFramesInFlight, {} };
+		auto it = mTextureDrawCommands.find( textureId );
+		if ( it != mTextureDrawCommands.end() ){
+			retired.drawCommand = std::move( it->second );
+			mTextureDrawCommands.erase( it );
+		} else if ( !retired.image && !retired.texture ){
+			return;
 		}
+		mRetiredTextures.push_back( std::move( retired ) );
+	}
 
+	//--------------------------------------------------------------
+
+	void EngineVk::evictUnusedTextures()
+	{
+		for ( auto it = mTextureDrawCommands.begin(); it != mTextureDrawCommands.end(); ){
+			if ( mFrameIndex - it->second.lastUsedFrame > kMaxUnusedFrames ){
+				it = mTextureDrawCommands.erase( it );
+			} else{
+				++it;
+			}
+		}
 	}
 
 	//--------------------------------------------------------------
@@ -264,12 +499,21 @@ namespace ofxImGui
 	
 	void EngineVk::createDrawCommands(){
 
+		mDrawCommand = createDrawCommand( false );
+		mCompactDrawCommand = createDrawCommand( true );
+	}
+
+	//--------------------------------------------------------------
+	
+	std::unique_ptr<of::vk::DrawCommand> EngineVk::createDrawCommand( bool compact ){
+
 		of::vk::Shader::Settings shaderSettings;
 
 		shaderSettings.device = mDevice;
-		shaderSettings.printDebugInfo = true;
-		shaderSettings.sources[::vk::ShaderStageFlagBits::eVertex]   = "imgui.vert";
-		shaderSettings.sources[::vk::ShaderStageFlagBits::eFragment] = "imgui.frag";
+		shaderSettings.printDebugInfo = ofGetLogLevel( "EngineVk" ) <= OF_LOG_VERBOSE;
+		// Embedded SPIR-V, nothing to load or compile at runtime
+		shaderSettings.sources[::vk::ShaderStageFlagBits::eVertex]   = of::vk::Shader::Source( std::vector<uint32_t>( std::begin( kImGuiVertSpv ), std::end( kImGuiVertSpv ) ) );
+		shaderSettings.sources[::vk::ShaderStageFlagBits::eFragment] = of::vk::Shader::Source( std::vector<uint32_t>( std::begin( kImGuiFragSpv ), std::end( kImGuiFragSpv ) ) );
 
 		auto vertexInfo = std::make_shared<of::vk::Shader::VertexInfo>();
 
@@ -297,8 +541,15 @@ namespace ofxImGui
 			.setFormat( ::vk::Format::eR8G8B8A8Unorm )
 			;
 		
+		if ( compact ){
+			// Same shaders: snorm positions are scaled back by the projection, unorm UVs are used as is
+			vertexInfo->attribute[0].setOffset( offsetof( CompactDrawVert, pos ) ).setFormat( ::vk::Format::eR16G16Snorm );
+			vertexInfo->attribute[1].setOffset( offsetof( CompactDrawVert, uv ) ).setFormat( ::vk::Format::eR16G16Unorm );
+			vertexInfo->attribute[2].setOffset( offsetof( CompactDrawVert, col ) );
+		}
+
 		// only one binding description, as we're only using one binding.
-		vertexInfo->bindingDescription = { { 0, sizeof( ImDrawVert ), ::vk::VertexInputRate::eVertex } };
+		vertexInfo->bindingDescription = { { 0, compact ? sizeof( CompactDrawVert ) : sizeof( ImDrawVert ), ::vk::VertexInputRate::eVertex } };
 
 		// by setting vertexInfo like this we prevent the shader from reflecting
 		shaderSettings.vertexInfo = vertexInfo;
@@ -332,9 +583,9 @@ namespace ofxImGui
 			.setColorWriteMask(::vk::ColorComponentFlagBits::eR | ::vk::ColorComponentFlagBits::eG | ::vk::ColorComponentFlagBits::eB | ::vk::ColorComponentFlagBits::eA )
 			;
 
-		mDrawCommand = std::make_unique<of::vk::DrawCommand>();
-		mDrawCommand->setup( pipeline );
-
+		auto drawCommand = std::make_unique<of::vk::DrawCommand>();
+		drawCommand->setup( pipeline );
+		return drawCommand;
 	}
 
 	//--------------------------------------------------------------
@@ -342,10 +593,9 @@ namespace ofxImGui
 	bool EngineVk::createDeviceObjects()
 	{
 		// create draw command prototype
-		createFontsTexture();
 		createDrawCommands();
-		// attach font texture to draw command
-		mDrawCommand->setTexture( "tex_unit_0", *mFontTexture );
+		// records the font upload and attaches the font texture to the draw command
+		createFontsTexture();
 
 		return true;
 	}
@@ -368,7 +618,15 @@ namespace ofxImGui
 		imgData.extent.width = width;
 		imgData.extent.height = height;
 
-		mFontImage = mRenderer->getStagingContext()->storeImageCmd( imgData, mImageAllocator );
+		// Only recorded here, the staging context is submitted ahead of the next frame's draws
+		ImageAllocatorBlock* block = nullptr;
+		const auto & allocator = reserveImageMemory( upload_size + kImageAlignmentSlack, block );
+		auto fontImage = mRenderer->getStagingContext()->storeImageCmd( imgData, allocator );
+		if ( !fontImage ){
+			ofLogError( "EngineVk" ) << "Could not upload the font atlas";
+			return false;
+		}
+		block->images.push_back( fontImage );
 
 		::vk::SamplerCreateInfo samplerInfo = of::vk::Texture::getDefaultSamplerCreateInfo();
 		
@@ -384,9 +642,23 @@ namespace ofxImGui
 			.setAddressModeW( ::vk::SamplerAddressMode::eRepeat )
 			;
 
-		auto imageViewCreateInfo = of::vk::Texture::getDefaultImageViewCreateInfo(*mFontImage);
+		auto imageViewCreateInfo = of::vk::Texture::getDefaultImageViewCreateInfo(*fontImage);
+
+		// The previous atlas may still be read by frames in flight
+		if ( mFontTexture ){
+			retireTexture( mFontTexture.get(), mFontImage, mFontTexture );
+		}
 
+		mFontImage = fontImage;
 		mFontTexture = std::make_shared<of::vk::Texture>( mRenderer->getVkDevice(), samplerInfo , imageViewCreateInfo);
+		mFontReadyFrame = mFrameIndex + 1;
+
+		if ( mDrawCommand ){
+			mDrawCommand->setTexture( "tex_unit_0", *mFontTexture );
+		}
+		if ( mCompactDrawCommand ){
+			mCompactDrawCommand->setTexture( "tex_unit_0", *mFontTexture );
+		}
 
 		// Store our identifier
 		io.Fonts->TexID = (void *)( mFontTexture.get());
@@ -397,10 +669,13 @@ namespace ofxImGui
 	//--------------------------------------------------------------
 	void EngineVk::invalidateDeviceObjects()
 	{
+		mTextureDrawCommands.clear();
 		mDrawCommand.reset();
-		mImageAllocator.reset();
+		mCompactDrawCommand.reset();
 		mFontTexture.reset();    // wrapper with sampler around font texture
 		mFontImage.reset();      // data store for image data
+		mRetiredTextures.clear();
+		mImageAllocators.clear();
 	}
 
 } // end namespace ofxImGui
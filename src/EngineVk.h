@@ -18,6 +18,9 @@
 #include "vk/DrawCommand.h"
 #include "vk/RenderBatch.h"
 
+#include <array>
+#include <unordered_map>
+
 class ofVkRenderer; // ffdecl.
 
 namespace ofxImGui
@@ -37,6 +40,8 @@ namespace ofxImGui
 		bool createDeviceObjects() override;
 		void invalidateDeviceObjects() override;
 
+		// Records the atlas upload without waiting for it, so it can also be called to rebuild the
+		// fonts at runtime. Text is skipped until the upload has landed.
 		bool createFontsTexture();
 
 		void onKeyReleased(ofKeyEventArgs& event) override;
@@ -47,18 +52,84 @@ namespace ofxImGui
 		static void render(ImDrawData * draw_data);
 		static void setRenderBatch( of::vk::RenderBatch& batch );
 
+		// Drops the draw command prepared for a texture, call before destroying a texture shown in the GUI.
+		// The draw command itself is destroyed once no frame in flight can use it anymore.
+		// Textures that were not drawn for a while are dropped automatically.
+		static void releaseTexture( ImTextureID textureId );
+
+		// Keeps the renderer's pipeline cache in this file, so the next launch creates the GUI pipeline
+		// without compiling it again. Empty, the default, disables it. Call before Gui::setup().
+		static void setPipelineCacheFile( const std::string& path );
+
 	private:
 
+		static const int kFramesInFlight = 3;           // upper bound of frames the renderer keeps in flight
+		static const uint64_t kMaxUnusedFrames = 300;
+
+		// Vertex layouts, each has its own pipeline
+		enum VertexFormat
+		{
+			VERTEX_FORMAT_FULL,     // ImDrawVert
+			VERTEX_FORMAT_COMPACT,  // CompactDrawVert
+			kNumVertexFormats
+		};
+
+		// Draw commands with the descriptors of one texture, one per vertex format and frame in flight, kept across frames
+		struct TextureDrawCommand
+		{
+			std::array<std::array<std::unique_ptr<of::vk::DrawCommand>, kFramesInFlight>, kNumVertexFormats> dcs;
+			std::array<std::array<uint64_t, kFramesInFlight>, kNumVertexFormats> preparedFrames;    // frame the buffers and uniforms were last set for
+			uint64_t lastUsedFrame = 0;
+
+			TextureDrawCommand() { for ( auto & frames : preparedFrames ) frames.fill( ~0ULL ); }
+		};
+
+		// Image memory, a new allocator is added when the current ones are full
+		struct ImageAllocatorBlock
+		{
+			std::unique_ptr<of::vk::ImageAllocator> allocator;
+			::vk::DeviceSize size = 0;
+			::vk::DeviceSize used = 0;
+			std::vector<std::weak_ptr<::vk::Image>> images;
+		};
+
+		// Kept alive until no frame in flight can use it anymore
+		struct RetiredTexture
+		{
+			std::shared_ptr<::vk::Image> image;
+			std::shared_ptr<of::vk::Texture> texture;
+			uint64_t releaseFrame;
+			TextureDrawCommand drawCommand;
+		};
+
+		static TextureDrawCommand& getTextureDrawCommand( ImTextureID textureId, int format );
+		static void evictUnusedTextures();
+		static bool isTextureReady( ImTextureID textureId );
+		static void releaseRetiredTextures();
+		static void retireTexture( ImTextureID textureId, std::shared_ptr<::vk::Image> image, std::shared_ptr<of::vk::Texture> texture );
+
+		const std::unique_ptr<of::vk::ImageAllocator>& reserveImageMemory( ::vk::DeviceSize size, ImageAllocatorBlock*& block );
+
+		static std::unordered_map<ImTextureID, TextureDrawCommand> mTextureDrawCommands;
+		static uint64_t mFrameIndex;
+		static uint64_t mFontReadyFrame;                                 // first frame the font upload is complete in
+		static std::vector<ImageAllocatorBlock> mImageAllocators;
+		static std::vector<RetiredTexture> mRetiredTextures;
+		static std::string mPipelineCacheFile;
+
 		static ::vk::Device                             mDevice;         // Non-owning reference to current VK device
 		std::shared_ptr<ofVkRenderer>                   mRenderer;       // Reference to current renderer
 		static ::of::vk::RenderBatch*                   batch;           // Current batch used for drawing
-		static std::unique_ptr<of::vk::ImageAllocator>  mImageAllocator; // Allocator used for font texture
 		static std::shared_ptr<::vk::Image>             mFontImage;      // Data store for image data
 		static std::shared_ptr<of::vk::Texture>         mFontTexture;    // Wrapper with sampler around font texture
 		static std::unique_ptr<of::vk::DrawCommand>     mDrawCommand;    // Used to draw ImGui components
+		static std::unique_ptr<of::vk::DrawCommand>     mCompactDrawCommand;    // Same, for CompactDrawVert
 		
 		void createDrawCommands();
-		void setupImageAllocator();
+		std::unique_ptr<of::vk::DrawCommand> createDrawCommand( bool compact );
+		void loadPipelineCache();
+		void storePipelineCache();
+		void setupImageAllocator( ::vk::DeviceSize size = ( 1 << 24UL ) );
 		
 	};
 
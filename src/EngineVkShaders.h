@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ofConstants.h"
+#if defined(OF_TARGET_API_VULKAN)
+
+#include <cstdint>
+
+// SPIR-V of shaders/imgui.vert and shaders/imgui.frag, so no shader files have to be shipped
+// or compiled at startup. Regenerate it with shaders/generate_spirv.sh instead of editing it.
+// The words below were assembled by hand and only checked by disassembling them against the
+// shaders, the script has not been run on them yet. Its --check option fails until it has.
+
+namespace ofxImGui
+{
+	const uint32_t kImGuiVertSpv[] =
+	{
+		0x07230203, 0x00010000, 0x00000000, 0x00000027, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+		0x00000000, 0x00000001, 0x000b000f, 0x00000000, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+		0x00000003, 0x00000004, 0x00000005, 0x00000006, 0x00000007, 0x00030003, 0x00000002, 0x000001c2,
+		0x00040005, 0x00000001, 0x6e69616d, 0x00000000, 0x00060005, 0x00000008, 0x61666544, 0x4d746c75,
+		0x69727461, 0x00736563, 0x000a0006, 0x00000008, 0x00000000, 0x65646f6d, 0x6569566c, 0x6f725077,
+		0x7463656a, 0x4d6e6f69, 0x69727461, 0x00000078, 0x00030005, 0x00000009, 0x00000000, 0x00040005,
+		0x00000004, 0x6f506e69, 0x00000073, 0x00050005, 0x00000005, 0x65546e69, 0x6f6f4378, 0x00006472,
+		0x00040005, 0x00000006, 0x6f436e69, 0x00726f6c, 0x00050005, 0x00000002, 0x4374756f, 0x726f6c6f,
+		0x00000000, 0x00050005, 0x00000003, 0x5474756f, 0x6f437865, 0x0064726f, 0x00060005, 0x0000000a,
+		0x505f6c67, 0x65567265, 0x78657472, 0x00000000, 0x00060006, 0x0000000a, 0x00000000, 0x505f6c67,
+		0x7469736f, 0x006e6f69, 0x00030005, 0x00000007, 0x00000000, 0x00040048, 0x00000008, 0x00000000,
+		0x00000005, 0x00050048, 0x00000008, 0x00000000, 0x00000023, 0x00000000, 0x00050048, 0x00000008,
+		0x00000000, 0x00000007, 0x00000010, 0x00030047, 0x00000008, 0x00000002, 0x00040047, 0x00000009,
+		0x00000022, 0x00000000, 0x00040047, 0x00000009, 0x00000021, 0x00000000, 0x00040047, 0x00000004,
+		0x0000001e, 0x00000000, 0x00040047, 0x00000005, 0x0000001e, 0x00000001, 0x00040047, 0x00000006,
+		0x0000001e, 0x00000002, 0x00040047, 0x00000002, 0x0000001e, 0x00000000, 0x00040047, 0x00000003,
+		0x0000001e, 0x00000001, 0x00050048, 0x0000000a, 0x00000000, 0x0000000b, 0x00000000, 0x00030047,
+		0x0000000a, 0x00000002, 0x00020013, 0x0000000b, 0x00030021, 0x0000000c, 0x0000000b, 0x00030016,
+		0x0000000d, 0x00000020, 0x00040017, 0x0000000e, 0x0000000d, 0x00000002, 0x00040017, 0x0000000f,
+		0x0000000d, 0x00000004, 0x00040018, 0x00000010, 0x0000000f, 0x00000004, 0x00040015, 0x00000011,
+		0x00000020, 0x00000001, 0x0004002b, 0x00000011, 0x00000012, 0x00000000, 0x0004002b, 0x0000000d,
+		0x00000013, 0x00000000, 0x0004002b, 0x0000000d, 0x00000014, 0x3f800000, 0x0003001e, 0x00000008,
+		0x00000010, 0x00040020, 0x00000015, 0x00000002, 0x00000008, 0x00040020, 0x00000016, 0x00000002,
+		0x00000010, 0x0003001e, 0x0000000a, 0x0000000f, 0x00040020, 0x00000017, 0x00000003, 0x0000000a,
+		0x00040020, 0x00000018, 0x00000001, 0x0000000e, 0x00040020, 0x00000019, 0x00000001, 0x0000000f,
+		0x00040020, 0x0000001a, 0x00000003, 0x0000000e, 0x00040020, 0x0000001b, 0x00000003, 0x0000000f,
+		0x0004003b, 0x00000015, 0x00000009, 0x00000002, 0x0004003b, 0x00000018, 0x00000004, 0x00000001,
+		0x0004003b, 0x00000018, 0x00000005, 0x00000001, 0x0004003b, 0x00000019, 0x00000006, 0x00000001,
+		0x0004003b, 0x0000001b, 0x00000002, 0x00000003, 0x0004003b, 0x0000001a, 0x00000003, 0x00000003,
+		0x0004003b, 0x00000017, 0x00000007, 0x00000003, 0x00050036, 0x0000000b, 0x00000001, 0x00000000,
+		0x0000000c, 0x000200f8, 0x0000001c, 0x0004003d, 0x0000000e, 0x0000001d, 0x00000005, 0x0003003e,
+		0x00000003, 0x0000001d, 0x0004003d, 0x0000000f, 0x0000001e, 0x00000006, 0x0003003e, 0x00000002,
+		0x0000001e, 0x00050041, 0x00000016, 0x0000001f, 0x00000009, 0x00000012, 0x0004003d, 0x00000010,
+		0x00000020, 0x0000001f, 0x0004003d, 0x0000000e, 0x00000021, 0x00000004, 0x00050051, 0x0000000d,
+		0x00000022, 0x00000021, 0x00000000, 0x00050051, 0x0000000d, 0x00000023, 0x00000021, 0x00000001,
+		0x00070050, 0x0000000f, 0x00000024, 0x00000022, 0x00000023, 0x00000013, 0x00000014, 0x00050091,
+		0x0000000f, 0x00000025, 0x00000020, 0x00000024, 0x00050041, 0x0000001b, 0x00000026, 0x00000007,
+		0x00000012, 0x0003003e, 0x00000026, 0x00000025, 0x000100fd, 0x00010038,
+	};
+
+	const uint32_t kImGuiFragSpv[] =
+	{
+		0x07230203, 0x00010000, 0x00000000, 0x00000017, 0x00000000, 0x00020011, 0x00000001, 0x0003000e,
+		0x00000000, 0x00000001, 0x0008000f, 0x00000004, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+		0x00000003, 0x00000004, 0x00030010, 0x00000001, 0x00000007, 0x00030003, 0x00000002, 0x000001c2,
+		0x00040005, 0x00000001, 0x6e69616d, 0x00000000, 0x00060005, 0x00000002, 0x4674756f, 0x43676172,
+		0x726f6c6f, 0x00000000, 0x00040005, 0x00000003, 0x6f436e69, 0x00726f6c, 0x00050005, 0x00000005,
+		0x5f786574, 0x74696e75, 0x0000305f, 0x00050005, 0x00000004, 0x65546e69, 0x6f6f4378, 0x00006472,
+		0x00040047, 0x00000002, 0x0000001e, 0x00000000, 0x00040047, 0x00000003, 0x0000001e, 0x00000000,
+		0x00040047, 0x00000004, 0x0000001e, 0x00000001, 0x00040047, 0x00000005, 0x00000022, 0x00000000,
+		0x00040047, 0x00000005, 0x00000021, 0x00000001, 0x00020013, 0x00000006, 0x00030021, 0x00000007,
+		0x00000006, 0x00030016, 0x00000008, 0x00000020, 0x00040017, 0x00000009, 0x00000008, 0x00000002,
+		0x00040017, 0x0000000a, 0x00000008, 0x00000004, 0x00090019, 0x0000000b, 0x00000008, 0x00000001,
+		0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000, 0x0003001b, 0x0000000c, 0x0000000b,
+		0x00040020, 0x0000000d, 0x00000000, 0x0000000c, 0x00040020, 0x0000000e, 0x00000001, 0x00000009,
+		0x00040020, 0x0000000f, 0x00000001, 0x0000000a, 0x00040020, 0x00000010, 0x00000003, 0x0000000a,
+		0x0004003b, 0x00000010, 0x00000002, 0x00000003, 0x0004003b, 0x0000000f, 0x00000003, 0x00000001,
+		0x0004003b, 0x0000000d, 0x00000005, 0x00000000, 0x0004003b, 0x0000000e, 0x00000004, 0x00000001,
+		0x00050036, 0x00000006, 0x00000001, 0x00000000, 0x00000007, 0x000200f8, 0x00000011, 0x0004003d,
+		0x0000000a, 0x00000012, 0x00000003, 0x0004003d, 0x0000000c, 0x00000013, 0x00000005, 0x0004003d,
+		0x00000009, 0x00000014, 0x00000004, 0x00050057, 0x0000000a, 0x00000015, 0x00000013, 0x00000014,
+		0x00050085, 0x0000000a, 0x00000016, 0x00000012, 0x00000015, 0x0003003e, 0x00000002, 0x00000016,
+		0x000100fd, 0x00010038,
+	};
+}
+
+#endif // OF_TARGET_API_VULKAN
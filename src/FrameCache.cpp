@@ -0,0 +1,361 @@
+#include "FrameCache.h"
+
+#if !defined(OF_TARGET_API_VULKAN)
+
+#include "BaseEngine.h"
+#include "ofGraphics.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace ofxImGui
+{
+	static const uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+	static const uint64_t kFnvPrime = 1099511628211ULL;
+
+	//--------------------------------------------------------------
+	static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		// FNV-1a over 64-bit words, the tail byte by byte
+		const unsigned char* bytes = (const unsigned char*)data;
+		size_t num_words = size / sizeof(uint64_t);
+		for (size_t i = 0; i < num_words; i++)
+		{
+			uint64_t word;
+			memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+			hash = (hash ^ word) * kFnvPrime;
+		}
+		for (size_t i = num_words * sizeof(uint64_t); i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * kFnvPrime;
+		}
+		return hash;
+	}
+
+	//--------------------------------------------------------------
+	FrameCache::FrameCache()
+		: lastHash(0)
+		, isValid(false)
+		, enabled(false)
+		, partialRedraw(false)
+	{}
+
+	//--------------------------------------------------------------
+	void FrameCache::setEnabled(bool enabled_)
+	{
+		enabled = enabled_;
+		if (!enabled)
+		{
+			fbo.clear();
+		}
+		invalidate();
+	}
+
+	//--------------------------------------------------------------
+	bool FrameCache::isEnabled() const
+	{
+		return enabled;
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::invalidate()
+	{
+		isValid = false;
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::setPartialRedraw(bool enabled_)
+	{
+		partialRedraw = enabled_;
+		lastListStates.clear();
+		invalidate();
+	}
+
+	//--------------------------------------------------------------
+	bool FrameCache::isPartialRedraw() const
+	{
+		return partialRedraw;
+	}
+
+	//--------------------------------------------------------------
+	uint64_t FrameCache::hashDrawData(const ImDrawData * draw_data)
+	{
+		uint64_t hash = kFnvOffsetBasis;
+		hash = hashBytes(hash, &draw_data->DisplayPos, sizeof(ImVec2));
+		hash = hashBytes(hash, &draw_data->DisplaySize, sizeof(ImVec2));
+		hash = hashBytes(hash, &draw_data->CmdListsCount, sizeof(int));
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			uint64_t list_hash = hashDrawList(draw_data->CmdLists[n]);
+			hash = hashBytes(hash, &list_hash, sizeof(list_hash));
+		}
+		return hash;
+	}
+
+	//--------------------------------------------------------------
+	uint64_t FrameCache::hashDrawList(const ImDrawList * cmd_list)
+	{
+		uint64_t hash = kFnvOffsetBasis;
+		hash = hashBytes(hash, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+		hash = hashBytes(hash, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+		for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+		{
+			// Only the fields that affect rendering, ImDrawCmd has padding and callback data
+			const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+			hash = hashBytes(hash, &pcmd->ElemCount, sizeof(pcmd->ElemCount));
+			hash = hashBytes(hash, &pcmd->VtxOffset, sizeof(pcmd->VtxOffset));
+			hash = hashBytes(hash, &pcmd->ClipRect, sizeof(pcmd->ClipRect));
+			hash = hashBytes(hash, &pcmd->TextureId, sizeof(pcmd->TextureId));
+		}
+		return hash;
+	}
+
+	//--------------------------------------------------------------
+	static void addRect(ImVec4& a, const ImVec4& b)
+	{
+		a.x = std::min(a.x, b.x);
+		a.y = std::min(a.y, b.y);
+		a.z = std::max(a.z, b.z);
+		a.w = std::max(a.w, b.w);
+	}
+
+	//--------------------------------------------------------------
+	static void intersectRect(ImVec4& a, const ImVec4& b)
+	{
+		a.x = std::max(a.x, b.x);
+		a.y = std::max(a.y, b.y);
+		a.z = std::min(a.z, b.z);
+		a.w = std::min(a.w, b.w);
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::updateListStates(const ImDrawData * draw_data)
+	{
+		listStates.resize(draw_data->CmdListsCount);
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			ListState& state = listStates[n];
+
+			const char* name = cmd_list->_OwnerName ? cmd_list->_OwnerName : "";
+			state.id = hashBytes(kFnvOffsetBasis, name, strlen(name));
+			state.hash = hashDrawList(cmd_list);
+			state.bounds = ImVec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+				if (pcmd->ElemCount > 0)
+				{
+					addRect(state.bounds, pcmd->ClipRect);
+				}
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool FrameCache::findDirtyRect(ImVec4& dirty_rect) const
+	{
+		// Lists that changed, appeared or disappeared dirty their old and new bounds.
+		// Everything is redrawn when the lists that stayed changed their stacking order.
+		dirty_rect = ImVec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+		std::vector<bool> isMatched(lastListStates.size(), false);
+		int last_match = -1;
+		for (const ListState& state : listStates)
+		{
+			int match = -1;
+			for (size_t i = 0; i < lastListStates.size(); i++)
+			{
+				if (!isMatched[i] && lastListStates[i].id == state.id)
+				{
+					match = (int)i;
+					break;
+				}
+			}
+
+			if (match < 0)
+			{
+				addRect(dirty_rect, state.bounds);
+				continue;
+			}
+			if (match < last_match)
+			{
+				return false;
+			}
+			last_match = match;
+			isMatched[match] = true;
+
+			const ListState& last_state = lastListStates[match];
+			if (last_state.hash != state.hash)
+			{
+				addRect(dirty_rect, state.bounds);
+				addRect(dirty_rect, last_state.bounds);
+			}
+		}
+		for (size_t i = 0; i < lastListStates.size(); i++)
+		{
+			if (!isMatched[i])
+			{
+				addRect(dirty_rect, lastListStates[i].bounds);
+			}
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::clipDrawData(ImDrawData * draw_data, const ImVec4& clip_rect)
+	{
+		// The draw data is drawn again when threaded or streamed, only the render into the fbo sees the narrowed rectangles
+		savedClipRects.clear();
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			ImDrawList* cmd_list = draw_data->CmdLists[n];
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				savedClipRects.push_back(cmd_list->CmdBuffer[cmd_i].ClipRect);
+				intersectRect(cmd_list->CmdBuffer[cmd_i].ClipRect, clip_rect);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::restoreClipRects(ImDrawData * draw_data)
+	{
+		size_t i = 0;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			ImDrawList* cmd_list = draw_data->CmdLists[n];
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				cmd_list->CmdBuffer[cmd_i].ClipRect = savedClipRects[i++];
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::draw(ImDrawData * draw_data, const std::function<void()>& render)
+	{
+		if (!draw_data || !draw_data->Valid)
+		{
+			return;
+		}
+
+		int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+		int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+		if (fb_width <= 0 || fb_height <= 0)
+		{
+			return;
+		}
+		displaySize = draw_data->DisplaySize;
+
+		// User callbacks can draw anything, render those frames directly
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				if (cmd_list->CmdBuffer[cmd_i].UserCallback)
+				{
+					invalidate();
+					render();
+					return;
+				}
+			}
+		}
+
+		if (!fbo.isAllocated() || (int)fbo.getWidth() != fb_width || (int)fbo.getHeight() != fb_height)
+		{
+			fbo.allocate(fb_width, fb_height, GL_RGBA);
+			invalidate();
+		}
+
+		bool isDirty = true;
+		bool isPartial = false;
+		ImVec4 dirty_rect;
+		if (partialRedraw)
+		{
+			updateListStates(draw_data);
+			if (isValid && findDirtyRect(dirty_rect))
+			{
+				// Snap to whole pixels so the cleared area and the scissor rectangles of the backend agree
+				intersectRect(dirty_rect, ImVec4(0.0f, 0.0f, draw_data->DisplaySize.x, draw_data->DisplaySize.y));
+				dirty_rect = ImVec4(floorf(dirty_rect.x), floorf(dirty_rect.y), ceilf(dirty_rect.z), ceilf(dirty_rect.w));
+				isDirty = !DrawBatch::isClipRectEmpty(dirty_rect);
+				isPartial = true;
+			}
+			listStates.swap(lastListStates);
+		}
+		else
+		{
+			uint64_t hash = hashDrawData(draw_data);
+			isDirty = !isValid || hash != lastHash;
+			lastHash = hash;
+		}
+
+		if (!isDirty)
+		{
+			BaseEngine::g_Stats.resetCounters();
+			BaseEngine::g_Stats.isCachedFrame = true;
+		}
+		else
+		{
+			fbo.begin();
+			if (isPartial)
+			{
+				// Same rounding as the scissor rectangles set by the backends
+				ImVec4 fb_rect = DrawBatch::scaleClipRect(dirty_rect, draw_data->FramebufferScale);
+				glEnable(GL_SCISSOR_TEST);
+				glScissor((int)fb_rect.x, (int)(fb_height - fb_rect.w), (int)(fb_rect.z - fb_rect.x), (int)(fb_rect.w - fb_rect.y));
+				ofClear(0, 0, 0, 0);
+				glDisable(GL_SCISSOR_TEST);
+
+				clipDrawData(draw_data, dirty_rect);
+			}
+			else
+			{
+				ofClear(0, 0, 0, 0);
+			}
+			BaseEngine::g_PremultipliedAlphaTarget = true;
+			render();
+			BaseEngine::g_PremultipliedAlphaTarget = false;
+			fbo.end();
+			if (isPartial)
+			{
+				restoreClipRects(draw_data);
+			}
+
+			isValid = true;
+		}
+
+		composite();
+	}
+
+	//--------------------------------------------------------------
+	bool FrameCache::drawCached()
+	{
+		if (!isValid || !fbo.isAllocated())
+		{
+			return false;
+		}
+		BaseEngine::g_Stats.resetCounters();
+		BaseEngine::g_Stats.isCachedFrame = true;
+		composite();
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void FrameCache::composite()
+	{
+		// The fbo holds premultiplied colors. The backends render with the origin at the
+		// top, so the texture is drawn flipped.
+		ofPushStyle();
+		ofEnableBlendMode(OF_BLENDMODE_ALPHA);
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		ofSetColor(255);
+		fbo.draw(0, displaySize.y, displaySize.x, -displaySize.y);
+		ofPopStyle();
+	}
+}
+
+#endif
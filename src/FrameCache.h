@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ofConstants.h"
+#if !defined(OF_TARGET_API_VULKAN)
+
+#include "ofFbo.h"
+#include "imgui.h"
+
+#include <functional>
+#include <vector>
+
+namespace ofxImGui
+{
+	// Keeps the last rendered GUI in an fbo and composites it instead of
+	// rendering again while the draw data stays the same.
+	class FrameCache
+	{
+	public:
+		FrameCache();
+
+		void setEnabled(bool enabled);
+		bool isEnabled() const;
+
+		// Forces the next frame to be rendered, e.g. after the contents of a texture used by the GUI changed
+		void invalidate();
+
+		// Only redraw the area covered by the draw lists that changed since the previous frame
+		void setPartialRedraw(bool enabled);
+		bool isPartialRedraw() const;
+
+		// Calls render into the fbo when draw_data differs from the cached frame, then draws the fbo
+		void draw(ImDrawData * draw_data, const std::function<void()>& render);
+
+		// Draws the cached frame as is, returns false when there is none
+		bool drawCached();
+
+		static uint64_t hashDrawData(const ImDrawData * draw_data);
+		static uint64_t hashDrawList(const ImDrawList * cmd_list);
+
+	private:
+		// What is remembered of a draw list to find it and compare it in the next frame
+		struct ListState
+		{
+			uint64_t id;        // hash of the owner name
+			uint64_t hash;
+			ImVec4 bounds;      // union of the clip rectangles of its commands
+		};
+
+		void updateListStates(const ImDrawData * draw_data);
+		bool findDirtyRect(ImVec4& dirty_rect) const;
+		// Narrows the clip rectangles to the dirty area, restoreClipRects() puts them back
+		void clipDrawData(ImDrawData * draw_data, const ImVec4& clip_rect);
+		void restoreClipRects(ImDrawData * draw_data);
+		void composite();
+
+		ofFbo fbo;
+		ImVec2 displaySize;     // of the cached frame
+		uint64_t lastHash;
+		bool isValid;
+		bool enabled;
+		bool partialRedraw;
+
+		std::vector<ListState> listStates;
+		std::vector<ListState> lastListStates;
+		std::vector<ImVec4> savedClipRects;     // of every command, in order, while clipped
+	};
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "GpuTimer.h"
+
+#if !defined(OF_TARGET_API_VULKAN)
+
+#include "BaseEngine.h"
+#include "ofAppRunner.h"
+#include "ofGLUtils.h"
+
+#if defined(TARGET_OPENGLES) && !defined(TARGET_OF_IOS)
+#include <EGL/egl.h>
+#endif
+
+namespace
+{
+	// Same values in GL 3.3, GL_ARB_timer_query and GL_EXT_disjoint_timer_query
+	const GLenum kTimeElapsed = 0x88BF;
+	const GLenum kQueryResult = 0x8866;
+	const GLenum kQueryResultAvailable = 0x8867;
+	const GLenum kGpuDisjoint = 0x8FBB;     // GLES only, set when results may be wrong, e.g. after a clock change
+
+#if defined(TARGET_OPENGLES)
+	typedef uint64_t TimerValue;
+	typedef void (GL_APIENTRY *GenQueriesFn)(GLsizei n, GLuint* ids);
+	typedef void (GL_APIENTRY *DeleteQueriesFn)(GLsizei n, const GLuint* ids);
+	typedef void (GL_APIENTRY *BeginQueryFn)(GLenum target, GLuint id);
+	typedef void (GL_APIENTRY *EndQueryFn)(GLenum target);
+	typedef void (GL_APIENTRY *GetQueryObjectuivFn)(GLuint id, GLenum pname, GLuint* params);
+	typedef void (GL_APIENTRY *GetQueryObjectui64vFn)(GLuint id, GLenum pname, TimerValue* params);
+#else
+	typedef GLuint64 TimerValue;
+	typedef void (GLAPIENTRY *GenQueriesFn)(GLsizei n, GLuint* ids);
+	typedef void (GLAPIENTRY *DeleteQueriesFn)(GLsizei n, const GLuint* ids);
+	typedef void (GLAPIENTRY *BeginQueryFn)(GLenum target, GLuint id);
+	typedef void (GLAPIENTRY *EndQueryFn)(GLenum target);
+	typedef void (GLAPIENTRY *GetQueryObjectuivFn)(GLuint id, GLenum pname, GLuint* params);
+	typedef void (GLAPIENTRY *GetQueryObjectui64vFn)(GLuint id, GLenum pname, TimerValue* params);
+#endif
+
+	GenQueriesFn genQueries = nullptr;
+	DeleteQueriesFn deleteQueries = nullptr;
+	BeginQueryFn beginQuery = nullptr;
+	EndQueryFn endQuery = nullptr;
+	GetQueryObjectuivFn getQueryObjectuiv = nullptr;
+	GetQueryObjectui64vFn getQueryObjectui64v = nullptr;
+
+	bool loadQueryFunctions()
+	{
+#if defined(TARGET_OF_IOS)
+		// No timer queries on Apple's GLES
+		return false;
+#elif defined(TARGET_OPENGLES)
+		if (!ofGLCheckExtension("GL_EXT_disjoint_timer_query"))
+		{
+			return false;
+		}
+		genQueries = (GenQueriesFn)eglGetProcAddress("glGenQueriesEXT");
+		deleteQueries = (DeleteQueriesFn)eglGetProcAddress("glDeleteQueriesEXT");
+		beginQuery = (BeginQueryFn)eglGetProcAddress("glBeginQueryEXT");
+		endQuery = (EndQueryFn)eglGetProcAddress("glEndQueryEXT");
+		getQueryObjectuiv = (GetQueryObjectuivFn)eglGetProcAddress("glGetQueryObjectuivEXT");
+		getQueryObjectui64v = (GetQueryObjectui64vFn)eglGetProcAddress("glGetQueryObjectui64vEXT");
+#else
+		auto renderer = ofGetGLRenderer();
+		bool isCore33 = renderer && (renderer->getGLVersionMajor() > 3 || (renderer->getGLVersionMajor() == 3 && renderer->getGLVersionMinor() >= 3));
+		if (!isCore33 && !ofGLCheckExtension("GL_ARB_timer_query"))
+		{
+			return false;
+		}
+		genQueries = glGenQueries;
+		deleteQueries = glDeleteQueries;
+		beginQuery = glBeginQuery;
+		endQuery = glEndQuery;
+		getQueryObjectuiv = glGetQueryObjectuiv;
+		getQueryObjectui64v = glGetQueryObjectui64v;
+#endif
+		return genQueries && deleteQueries && beginQuery && endQuery && getQueryObjectuiv && getQueryObjectui64v;
+	}
+}
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	bool GpuTimer::isSupported()
+	{
+		if (!isChecked)
+		{
+			isChecked = true;
+			supported = loadQueryFunctions();
+			if (supported)
+			{
+				genQueries(kNumQueries, queries);
+			}
+		}
+		return supported;
+	}
+
+	//--------------------------------------------------------------
+	bool GpuTimer::begin(TimingHistory& history)
+	{
+		if (!isSupported())
+		{
+			return false;
+		}
+
+#if defined(TARGET_OPENGLES)
+		GLint disjoint = 0;
+		glGetIntegerv(kGpuDisjoint, &disjoint);
+#else
+		const GLint disjoint = 0;
+#endif
+		while (numPending > 0)
+		{
+			// Queries complete in order, stop at the first one that has not
+			GLuint available = 0;
+			getQueryObjectuiv(queries[first], kQueryResultAvailable, &available);
+			if (!available)
+			{
+				break;
+			}
+			TimerValue nanoseconds = 0;
+			getQueryObjectui64v(queries[first], kQueryResult, &nanoseconds);
+			if (!disjoint)
+			{
+				history.add(nanoseconds / 1000000.0f);
+			}
+			first = (first + 1) % kNumQueries;
+			numPending--;
+		}
+
+		if (numPending == kNumQueries)
+		{
+			return false;
+		}
+		beginQuery(kTimeElapsed, queries[(first + numPending) % kNumQueries]);
+		numPending++;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void GpuTimer::end()
+	{
+		endQuery(kTimeElapsed);
+	}
+
+	//--------------------------------------------------------------
+	void GpuTimer::exit()
+	{
+		if (supported)
+		{
+			deleteQueries(kNumQueries, queries);
+		}
+		first = 0;
+		numPending = 0;
+		isChecked = false;
+		supported = false;
+	}
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ofConstants.h"
+#if !defined(OF_TARGET_API_VULKAN)
+
+namespace ofxImGui
+{
+	struct TimingHistory;
+
+	// GPU time of a span of GL calls, measured with time elapsed queries. Results are collected
+	// once the GPU has them, a few frames later, so the pipeline is never stalled. Needs GL 3.3 or
+	// GL_ARB_timer_query on desktop and GL_EXT_disjoint_timer_query on GLES. Time elapsed queries
+	// do not nest, the app must not have one running around the GUI draw.
+	class GpuTimer
+	{
+	public:
+		static const int kNumQueries = 4;   // spans in flight, no new span is measured while all are
+
+		// Adds the results that arrived to history and starts measuring, returns false when it
+		// did not, because timer queries are not supported or all queries are still in flight.
+		// Creates the queries the first time, needs the GL context.
+		bool begin(TimingHistory& history);
+		void end();
+
+		bool isSupported();
+
+		// Deletes the queries, call before the context goes away
+		void exit();
+
+	private:
+		GLuint queries[kNumQueries] = { 0 };
+		int first = 0;          // oldest query in flight
+		int numPending = 0;
+		bool isChecked = false;
+		bool supported = false;
+	};
+}
+
+#endif
@@ -2,6 +2,12 @@
 
 #include "ofAppRunner.h"
 
+namespace
+{
+	const int kSettleFrames = 3;                // frames built after an input event until hover states and layout settle
+	const float kCursorBlinkInterval = 0.2f;    // wake-up interval while a text field is focused
+	const float kHoverInterval = 0.1f;          // wake-up interval while an item is hovered, for delayed tooltips
+}
 
 
 namespace ofxImGui
@@ -9,8 +15,22 @@ namespace ofxImGui
 	//--------------------------------------------------------------
 	Gui::Gui()
 		: lastTime(0.0f)
+		, reactive(false)
+		, maxIdleInterval(1.0f)
+		, wakeUpTime(0.0f)
+		, settleFrames(0)
+		, updateInterval(0.0f)
+		, nextUpdateTime(0.0f)
+		, isRedrawRequested(false)
+		, isFrameSkipped(false)
+		, threadedDraw(false)
 		, theme(nullptr)
 	{
+#if defined(OFXIMGUI_ENGINE_NULL)
+		engine = &nullEngine;
+#else
+		engine = &platformEngine;
+#endif
 		ImGui::CreateContext();
 	}
 
@@ -32,7 +52,12 @@ namespace ofxImGui
 
 
 		autoDraw = autoDraw_;
-		engine.setup(autoDraw);
+		engine->setup(autoDraw);
+
+		for (const auto& timing : engine->getSetupTimings())
+		{
+			ofLogVerbose("ofxImGui") << "setup " << timing.phase << ": " << timing.milliseconds << " ms";
+		}
 
 		if (theme_)
 		{
@@ -48,7 +73,8 @@ namespace ofxImGui
 	//--------------------------------------------------------------
 	void Gui::exit()
 	{
-        engine.exit();
+        remoteServer.exit();
+        engine->exit();
 		if (theme)
 		{
 			delete theme;
@@ -79,12 +105,441 @@ namespace ofxImGui
 		theme->setup();
 	}
 
+	//--------------------------------------------------------------
+	const RenderStats& Gui::getStats() const
+	{
+		if (!threadedDraw)
+		{
+			return engine->g_Stats;
+		}
+		// The drawing thread records into g_Stats at the same time, only the timings of begin() and end() are read from it
+		std::lock_guard<std::mutex> lock(statsMutex);
+		threadedStats.copyDrawStats(drawThreadStats);
+		threadedStats.timings.newFrame = engine->g_Stats.timings.newFrame;
+		threadedStats.timings.render = engine->g_Stats.timings.render;
+		return threadedStats;
+	}
+
+	//--------------------------------------------------------------
+	void Gui::setTiming(bool enabled)
+	{
+		BaseEngine::setTiming(enabled);
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isTiming() const
+	{
+		return BaseEngine::g_UseTiming;
+	}
+
+	//--------------------------------------------------------------
+	void Gui::drawStatsOverlay(bool* p_open)
+	{
+		const float margin = 10.0f;
+		ImGuiIO& io = ImGui::GetIO();
+		ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - margin, margin), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+		ImGui::SetNextWindowBgAlpha(0.6f);
+		ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_AlwaysAutoResize
+			| ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+		if (!ImGui::Begin("ofxImGui stats", p_open, flags))
+		{
+			ImGui::End();
+			return;
+		}
+
+		const RenderStats& stats = getStats();
+		ImGui::Text("%u draw calls, %u merged, %u GL calls avoided%s", stats.drawCalls, stats.mergedDrawCalls, stats.glCallsAvoided, stats.isCachedFrame ? ", cached" : "");
+
+		if (!isTiming())
+		{
+			ImGui::TextDisabled("Timing is off, see Gui::setTiming()");
+		}
+		else
+		{
+			const std::pair<const char*, const TimingHistory*> rows[] = {
+				{ "NewFrame", &stats.timings.newFrame },
+				{ "Render", &stats.timings.render },
+				{ "Draw", &stats.timings.draw },
+				{ "GPU draw", &stats.timings.gpuDraw },
+			};
+
+			ImGui::Separator();
+			ImGui::Columns(6, nullptr, false);
+			for (const char* label : { "ms", "last", "avg", "p50", "p95", "p99" })
+			{
+				ImGui::TextDisabled("%s", label);
+				ImGui::NextColumn();
+			}
+			for (const auto& row : rows)
+			{
+				const TimingHistory& history = *row.second;
+				ImGui::TextUnformatted(row.first);
+				ImGui::NextColumn();
+				if (history.isEmpty())
+				{
+					for (int i = 0; i < 5; i++)
+					{
+						ImGui::TextDisabled("-");
+						ImGui::NextColumn();
+					}
+					continue;
+				}
+				for (float value : { history.getLast(), history.getAverage(), history.getPercentile(50.0f), history.getPercentile(95.0f), history.getPercentile(99.0f) })
+				{
+					ImGui::Text("%.3f", value);
+					ImGui::NextColumn();
+				}
+			}
+			ImGui::Columns(1);
+
+			// The GPU time where there is one, it is what ends up limiting the frame rate
+			const TimingHistory& plotted = stats.timings.gpuDraw.isEmpty() ? stats.timings.draw : stats.timings.gpuDraw;
+			if (!plotted.isEmpty())
+			{
+				int offset = plotted.count < TimingHistory::kNumSamples ? 0 : plotted.next;
+				ImGui::PlotLines("##history", plotted.samples, plotted.count, offset, &plotted == &stats.timings.gpuDraw ? "GPU draw" : "Draw", 0.0f, FLT_MAX, ImVec2(0.0f, 40.0f));
+			}
+		}
+
+		if (p_open && ImGui::BeginPopupContextWindow())
+		{
+			if (ImGui::MenuItem("Close"))
+			{
+				*p_open = false;
+			}
+			ImGui::EndPopup();
+		}
+		ImGui::End();
+	}
+
+	//--------------------------------------------------------------
+	void Gui::setDrawListProfiling(bool enabled)
+	{
+		drawListProfiler.setEnabled(enabled);
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isDrawListProfiling() const
+	{
+		return drawListProfiler.isEnabled();
+	}
+
+	//--------------------------------------------------------------
+	const DrawListProfiler& Gui::getDrawListProfiler() const
+	{
+		return drawListProfiler;
+	}
+
+	//--------------------------------------------------------------
+	void Gui::drawDrawListProfiler(bool* p_open)
+	{
+		drawListProfiler.draw(p_open);
+	}
+
+	//--------------------------------------------------------------
+	void Gui::setHeadless(bool enabled, bool rasterize)
+	{
+		BaseEngine* selected = rasterize ? (BaseEngine*)&softwareEngine : (BaseEngine*)&nullEngine;
+#if !defined(OFXIMGUI_ENGINE_NULL)
+		if (!enabled)
+		{
+			selected = &platformEngine;
+		}
+#endif
+		if (selected != engine)
+		{
+			engine->exit();
+			engine = selected;
+		}
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isHeadless() const
+	{
+		return engine == &nullEngine || engine == &softwareEngine;
+	}
+
+	//--------------------------------------------------------------
+	const ofPixels& Gui::getHeadlessPixels() const
+	{
+		return EngineSoftware::getPixels();
+	}
+
+	//--------------------------------------------------------------
+	const std::vector<SetupTiming>& Gui::getSetupTimings() const
+	{
+		return engine->getSetupTimings();
+	}
+
+	//--------------------------------------------------------------
+	void Gui::setReactive(bool enabled, float maxIdleInterval_)
+	{
+		reactive = enabled;
+		maxIdleInterval = maxIdleInterval_;
+		requestRedraw();
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isReactive() const
+	{
+		return reactive;
+	}
+
+	//--------------------------------------------------------------
+	void Gui::setUpdateRate(float rate)
+	{
+		updateInterval = rate > 0.0f ? 1.0f / rate : 0.0f;
+		nextUpdateTime = 0.0f;
+#if !defined(OF_TARGET_API_VULKAN)
+		if (updateInterval > 0.0f)
+		{
+			updateFrameCache([this]()
+			{
+				if (!frameCache.isEnabled())
+				{
+					frameCache.setEnabled(true);
+				}
+			});
+		}
+#endif
+	}
 
+	//--------------------------------------------------------------
+	float Gui::getUpdateRate() const
+	{
+		return updateInterval > 0.0f ? 1.0f / updateInterval : 0.0f;
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::needsRedraw() const
+	{
+		if (!reactive && updateInterval <= 0.0f)
+		{
+			return true;
+		}
+		if (isMinimized())
+		{
+			return false;
+		}
+		if (updateInterval > 0.0f && ofGetElapsedTimef() < nextUpdateTime)
+		{
+			return false;
+		}
+		if (!reactive)
+		{
+			return true;
+		}
+		return isRedrawRequested || engine->pendingInputEvents > 0 || settleFrames > 0 || ofGetElapsedTimef() >= wakeUpTime;
+	}
+
+	//--------------------------------------------------------------
+	float Gui::getWakeUpTime() const
+	{
+		return wakeUpTime;
+	}
+
+	//--------------------------------------------------------------
+	void Gui::requestRedraw()
+	{
+		isRedrawRequested = true;
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isMinimized() const
+	{
+		if (ofGetWidth() <= 0 || ofGetHeight() <= 0)
+		{
+			return true;
+		}
+#if !defined(TARGET_OPENGLES) && !defined(OF_TARGET_API_VULKAN) && !defined(OFXIMGUI_ENGINE_NULL)
+		GLFWwindow* window = (GLFWwindow*)ofGetWindowPtr()->getWindowContext();
+		return window && glfwGetWindowAttrib(window, GLFW_ICONIFIED);
+#else
+		return false;
+#endif
+	}
+
+	//--------------------------------------------------------------
+	void Gui::updateWakeUpTime()
+	{
+		ImGuiIO& io = ImGui::GetIO();
+		float currentTime = ofGetElapsedTimef();
+
+		bool isMouseDown = false;
+		for (int i = 0; i < 5; i++)
+		{
+			isMouseDown |= io.MouseDown[i];
+		}
+
+		if (ImGui::IsAnyItemActive() || isMouseDown)
+		{
+			// Dragging, held buttons and other interactions update every frame
+			wakeUpTime = currentTime;
+		}
+		else if (io.WantTextInput)
+		{
+			wakeUpTime = currentTime + std::min(kCursorBlinkInterval, maxIdleInterval);
+		}
+		else if (ImGui::IsAnyItemHovered())
+		{
+			wakeUpTime = currentTime + std::min(kHoverInterval, maxIdleInterval);
+		}
+		else
+		{
+			wakeUpTime = currentTime + maxIdleInterval;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void Gui::drawPreviousFrame()
+	{
+		if (isMinimized())
+		{
+			return;
+		}
+#if !defined(OF_TARGET_API_VULKAN)
+		if (frameCache.isEnabled() && frameCache.drawCached())
+		{
+			return;
+		}
+#endif
+		ImDrawData* draw_data = ImGui::GetDrawData();
+		if (!draw_data || !draw_data->Valid)
+		{
+			return;
+		}
+
+		ImGuiIO& io = ImGui::GetIO();
+		if (autoDraw && io.RenderDrawListsFn)
+		{
+			io.RenderDrawListsFn(draw_data);
+		}
+		else
+		{
+			engine->draw();
+		}
+	}
+
+	//--------------------------------------------------------------
+	void Gui::drawHandoffFrame()
+	{
+#if !defined(OF_TARGET_API_VULKAN)
+		applyFrameCacheUpdates();
+#endif
+		ImDrawData* draw_data = drawHandoff.acquire();
+		if (!draw_data)
+		{
+			return;
+		}
+#if !defined(OF_TARGET_API_VULKAN)
+		if (frameCache.isEnabled())
+		{
+			frameCache.draw(draw_data, [this, draw_data]() { engine->drawData(draw_data); });
+		}
+		else
+#endif
+		{
+			engine->drawData(draw_data);
+		}
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		drawThreadStats.copyDrawStats(engine->g_Stats);
+	}
+
+#if !defined(OF_TARGET_API_VULKAN)
+	//--------------------------------------------------------------
+	void Gui::updateFrameCache(const std::function<void()>& update)
+	{
+		if (!threadedDraw)
+		{
+			update();
+			return;
+		}
+		std::lock_guard<std::mutex> lock(frameCacheMutex);
+		frameCacheUpdates.push_back(update);
+	}
+
+	//--------------------------------------------------------------
+	void Gui::applyFrameCacheUpdates()
+	{
+		std::lock_guard<std::mutex> lock(frameCacheMutex);
+		for (const auto& update : frameCacheUpdates)
+		{
+			update();
+		}
+		frameCacheUpdates.clear();
+	}
+#endif
+
+	//--------------------------------------------------------------
+	void Gui::setThreadedDraw(bool enabled)
+	{
+#if defined(OF_TARGET_API_VULKAN)
+		if (enabled)
+		{
+			ofLogWarning("ofxImGui") << "Threaded draw is not available with Vulkan, the renderer records the GUI itself";
+			return;
+		}
+#endif
+		if (enabled && autoDraw)
+		{
+			ofLogWarning("ofxImGui") << "Threaded draw needs setup() with autoDraw off";
+			return;
+		}
+		threadedDraw = enabled;
+		drawHandoff.clear();
+#if !defined(OF_TARGET_API_VULKAN)
+		if (!enabled)
+		{
+			// The drawing thread is gone, the cache is this thread's again
+			applyFrameCacheUpdates();
+		}
+#endif
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isThreadedDraw() const
+	{
+		return threadedDraw;
+	}
+
+#if !defined(OF_TARGET_API_VULKAN)
+	//--------------------------------------------------------------
+	void Gui::setFrameCaching(bool enabled)
+	{
+		updateFrameCache([this, enabled]() { frameCache.setEnabled(enabled); });
+	}
+
+	//--------------------------------------------------------------
+	void Gui::invalidateFrameCache()
+	{
+		updateFrameCache([this]() { frameCache.invalidate(); });
+	}
+
+	//--------------------------------------------------------------
+	void Gui::setPartialRedraw(bool enabled)
+	{
+		updateFrameCache([this, enabled]()
+		{
+			if (enabled && !frameCache.isEnabled())
+			{
+				frameCache.setEnabled(true);
+			}
+			frameCache.setPartialRedraw(enabled);
+		});
+	}
+#endif
 
 	//--------------------------------------------------------------
 	GLuint Gui::loadPixels(ofPixels& pixels)
 	{
-		return engine.loadTextureImage2D(pixels.getData(), pixels.getWidth(), pixels.getHeight());
+		return engine->loadTextureImage2D(pixels.getData(), pixels.getWidth(), pixels.getHeight());
+	}
+
+	//--------------------------------------------------------------
+	void Gui::deleteTexture(GLuint texture)
+	{
+		engine->deleteTexture(texture);
 	}
 
 	//--------------------------------------------------------------
@@ -131,17 +586,51 @@ namespace ofxImGui
 		{
 			ofEnableArbTex();
 		}
+#if !defined(OF_TARGET_API_VULKAN)
+		// The texture may have been reloaded in place
+		invalidateFrameCache();
+#endif
 		return texture.getTextureData().textureID;
 	}
 
 	//--------------------------------------------------------------
-	void Gui::begin()
+	bool Gui::begin()
 	{
-		
+		if (remoteServer.update(*engine))
+		{
+			// A new viewer starts from a whole frame
+			requestRedraw();
+		}
+
+		isFrameSkipped = !needsRedraw();
+		if (isFrameSkipped)
+		{
+			return false;
+		}
+
+		if (engine->takeInputEvents() > 0)
+		{
+			settleFrames = kSettleFrames;
+		}
+		else if (settleFrames > 0)
+		{
+			settleFrames--;
+		}
+		isRedrawRequested = false;
 
 		ImGuiIO& io = ImGui::GetIO();
 
 		float currentTime = ofGetElapsedTimef();
+		if (updateInterval > 0.0f)
+		{
+			// Keep the cadence unless we fell behind by more than a tick
+			nextUpdateTime += updateInterval;
+			if (nextUpdateTime < currentTime)
+			{
+				nextUpdateTime = currentTime + updateInterval;
+			}
+		}
+
 		if (lastTime > 0.f)
 		{
 			io.DeltaTime = currentTime - lastTime;
@@ -153,25 +642,158 @@ namespace ofxImGui
 		lastTime = currentTime;
 
 		// Update settings
-		io.MousePos = ImVec2((float)ofGetMouseX(), (float)ofGetMouseY());
+		io.MousePos = remoteServer.hasMousePosition() ? remoteServer.getMousePosition() : ImVec2((float)ofGetMouseX(), (float)ofGetMouseY());
 		for (int i = 0; i < 5; i++) {
-			io.MouseDown[i] = engine.mousePressed[i];
+			io.MouseDown[i] = engine->mousePressed[i] || engine->mouseLatched[i];
+			engine->mouseLatched[i] = false;
+		}
+
+		// Keys pressed and released again since the last frame are down for this one
+		std::vector<int> releasedKeys;
+		for (int key : engine->latchedKeys)
+		{
+			if (key >= 0 && key < IM_ARRAYSIZE(io.KeysDown) && !io.KeysDown[key])
+			{
+				io.KeysDown[key] = true;
+				releasedKeys.push_back(key);
+			}
 		}
+		engine->latchedKeys.clear();
+
+		uint64_t newFrameStart = ofGetElapsedTimeMicros();
+		Tracer::begin("NewFrame");
 		ImGui::NewFrame();
+		Tracer::end();
+		if (BaseEngine::g_UseTiming)
+		{
+			engine->g_Stats.timings.newFrame.add((ofGetElapsedTimeMicros() - newFrameStart) / 1000.0f);
+		}
+
+		for (int key : releasedKeys)
+		{
+			io.KeysDown[key] = false;
+		}
+		return true;
 	}
 
 	//--------------------------------------------------------------
 	void Gui::end()
 	{
+		if (isFrameSkipped)
+		{
+			if (autoDraw)
+			{
+				drawPreviousFrame();
+			}
+			return;
+		}
+		if (reactive)
+		{
+			updateWakeUpTime();
+		}
+
+		if (threadedDraw)
+		{
+			// autoDraw is off, Render() only finalizes the draw data
+			render();
+			remoteServer.sendFrame(ImGui::GetDrawData());
+			drawHandoff.push(ImGui::GetDrawData());
+			return;
+		}
+
+#if !defined(OF_TARGET_API_VULKAN)
+		if (autoDraw && frameCache.isEnabled())
+		{
+			// The cache decides whether to render
+			renderWithoutDrawing();
+			frameCache.draw(ImGui::GetDrawData(), [this]() { engine->draw(); });
+			return;
+		}
+#endif
+		// Engines leave the draw data as it is, it can be streamed after drawing
+		render();
+		remoteServer.sendFrame(ImGui::GetDrawData());
+	}
+
+	//--------------------------------------------------------------
+	void Gui::render()
+	{
+		FrameTimings& timings = engine->g_Stats.timings;
+		uint64_t renderStart = ofGetElapsedTimeMicros();
+		// With autoDraw the engine draws from within Render(), that time is already counted as draw.
+		// Without, draws happen in draw(), maybe on another thread, and drawMicros is not read.
+		uint64_t drawMicros = autoDraw ? timings.drawMicros : 0;
+		Tracer::begin("Render");
 		ImGui::Render();
+		Tracer::end();
+		if (BaseEngine::g_UseTiming)
+		{
+			uint64_t micros = ofGetElapsedTimeMicros() - renderStart - (autoDraw ? timings.drawMicros - drawMicros : 0);
+			timings.render.add(micros / 1000.0f);
+		}
+		drawListProfiler.update(ImGui::GetDrawData());
+	}
+
+	//--------------------------------------------------------------
+	void Gui::renderWithoutDrawing()
+	{
+		// Keep ImGui::Render() from drawing
+		ImGuiIO& io = ImGui::GetIO();
+		void (*renderDrawListsFn)(ImDrawData*) = io.RenderDrawListsFn;
+		io.RenderDrawListsFn = nullptr;
+		render();
+		io.RenderDrawListsFn = renderDrawListsFn;
+
+		remoteServer.sendFrame(ImGui::GetDrawData());
+	}
+
+	//--------------------------------------------------------------
+	void Gui::drawData(ImDrawData * draw_data)
+	{
+		engine->drawData(draw_data);
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::setRemoteStreaming(bool enabled, int port, const std::string& address)
+	{
+		if (!enabled)
+		{
+			remoteServer.exit();
+			return true;
+		}
+		return remoteServer.setup(port, address);
+	}
+
+	//--------------------------------------------------------------
+	bool Gui::isRemoteStreaming() const
+	{
+		return remoteServer.isSetup();
 	}
 
 	//--------------------------------------------------------------
 	void Gui::draw()
 	{
+		if (threadedDraw)
+		{
+			// Frames skipped by the building thread simply leave the previous snapshot in place
+			drawHandoffFrame();
+			return;
+		}
 		if (!autoDraw)
 		{
-			engine.draw();
+			if (isFrameSkipped)
+			{
+				drawPreviousFrame();
+				return;
+			}
+#if !defined(OF_TARGET_API_VULKAN)
+			if (frameCache.isEnabled())
+			{
+				frameCache.draw(ImGui::GetDrawData(), [this]() { engine->draw(); });
+				return;
+			}
+#endif
+			engine->draw();
 		}
 	}
 }
@@ -4,15 +4,29 @@
 #include "ofPixels.h"
 #include "ofTexture.h"
 
-#if defined(TARGET_OPENGLES)
+#if defined(OFXIMGUI_ENGINE_NULL)
+// Only the null engine is built in
+#elif defined(TARGET_OPENGLES)
 #include "EngineOpenGLES.h"
 #elif defined (OF_TARGET_API_VULKAN)
 #include "EngineVk.h"
 #else
 #include "EngineGLFW.h"
 #endif
+#include "EngineNull.h"
+#include "EngineSoftware.h"
 
 #include "DefaultTheme.h"
+#include "DrawDataSnapshot.h"
+#include "DrawListProfiler.h"
+#include "FrameCache.h"
+#include "RemoteGui.h"
+#include "ShaderCache.h"
+#include "Tracer.h"
+
+#include <functional>
+#include <mutex>
+#include <vector>
 
 namespace ofxImGui
 {
@@ -25,36 +39,157 @@ namespace ofxImGui
 		void setup(BaseTheme* theme = nullptr, bool autoDraw = true);
 		void exit();
 
-		void begin();
+		// Returns false when the frame is skipped in reactive mode, no widgets must be submitted then.
+		// The previous GUI output is drawn again by end() or draw().
+		bool begin();
 		void end();
 
 		void draw();
 
+		// Draws draw data built elsewhere, like the frames of a RemoteViewer. Not available with Vulkan.
+		void drawData(ImDrawData * draw_data);
+
 		void setTheme(BaseTheme* theme);
 
+		const RenderStats& getStats() const;
+
+		// Record how long ImGui::NewFrame(), ImGui::Render() and the engine's draw take on the CPU,
+		// and the draw on the GPU where the engine can measure it, into getStats().timings
+		void setTiming(bool enabled);
+		bool isTiming() const;
+
+		// Small window in the top right corner with the counters and timings of getStats(),
+		// call between begin() and end(). Its context menu closes it through p_open.
+		void drawStatsOverlay(bool* p_open = nullptr);
+
+		// Count vertices, indices, draw commands and texture switches per window in every frame built.
+		// drawDrawListProfiler() shows them, call it between begin() and end().
+		void setDrawListProfiling(bool enabled);
+		bool isDrawListProfiling() const;
+		const DrawListProfiler& getDrawListProfiler() const;
+		void drawDrawListProfiler(bool* p_open = nullptr);
+
+		// Use EngineNull instead of the platform engine, for running without a graphics context,
+		// or EngineSoftware with rasterize to also render the GUI into getHeadlessPixels().
+		// Call before setup(). Always on when built with OFXIMGUI_ENGINE_NULL.
+		void setHeadless(bool enabled, bool rasterize = false);
+		bool isHeadless() const;
+		const ofPixels& getHeadlessPixels() const;
+
+		// How long the phases of setup() took, also logged at OF_LOG_VERBOSE
+		const std::vector<SetupTiming>& getSetupTimings() const;
+
+		// Only build a new GUI frame on input, while widgets are active or animating,
+		// and at least every maxIdleInterval seconds. Nothing is done while minimized.
+		void setReactive(bool enabled, float maxIdleInterval = 1.0f);
+		bool isReactive() const;
+
+		// Build the GUI at most rate times per second, 0 builds it every frame. The last output is
+		// drawn in between, from the frame cache which this enables (not available on Vulkan).
+		// Clicks and key presses that happen between two GUI frames are kept for the next one.
+		void setUpdateRate(float rate);
+		float getUpdateRate() const;
+
+		// Whether the next begin() will build a frame
+		bool needsRedraw() const;
+
+		// Time at which the GUI has to be built again even without input, in ofGetElapsedTimef() seconds
+		float getWakeUpTime() const;
+
+		// Builds the next frame, e.g. after the app changed values shown in the GUI
+		void requestRedraw();
+
+		// Lets draw() run on another thread than begin() and end(), at the same time. end() copies
+		// the frame into a snapshot and draw() renders the latest one. The drawing thread needs the
+		// GL context. Call after setup() with autoDraw off, not available with Vulkan. Frame cache
+		// settings are applied by the drawing thread before its next frame, getStats() returns the
+		// stats of the last frame it drew.
+		void setThreadedDraw(bool enabled);
+		bool isThreadedDraw() const;
+
+		// Streams the GUI frames to a RemoteViewer connecting on port, whose input is applied
+		// like local input. Listens on the loopback interface unless an other address is given.
+		bool setRemoteStreaming(bool enabled, int port = kDefaultRemotePort, const std::string& address = "127.0.0.1");
+		bool isRemoteStreaming() const;
+
+#if !defined(OF_TARGET_API_VULKAN)
+		// Reuse the previous GUI output while the draw data does not change.
+		// Call invalidateFrameCache() when a texture shown in the GUI is updated.
+		void setFrameCaching(bool enabled);
+		void invalidateFrameCache();
+
+		// Only redraw the windows that changed into the cached GUI layer, enables frame caching
+		void setPartialRedraw(bool enabled);
+#endif
+
 		GLuint loadImage(ofImage& image);
 		GLuint loadImage(const std::string& imagePath);
 
 		GLuint loadPixels(const std::string& imagePath);
 		GLuint loadPixels(ofPixels& pixels);
 
+		// Frees a texture returned by one of the load functions
+		void deleteTexture(GLuint texture);
+
 		GLuint loadTexture(const std::string& imagePath);
 		GLuint loadTexture(ofTexture& texture, const std::string& imagePath);
 
-	private:        
-#if defined(TARGET_OPENGLES)
-        EngineOpenGLES engine;
+	private:
+		bool isMinimized() const;
+		void updateWakeUpTime();
+		void drawPreviousFrame();
+		void drawHandoffFrame();
+#if !defined(OF_TARGET_API_VULKAN)
+		void updateFrameCache(const std::function<void()>& update);
+		void applyFrameCacheUpdates();
+#endif
+		void render();
+		void renderWithoutDrawing();
+
+#if defined(OFXIMGUI_ENGINE_NULL)
+#elif defined(TARGET_OPENGLES)
+        EngineOpenGLES platformEngine;
 #elif defined (OF_TARGET_API_VULKAN) 
-        EngineVk engine;
+        EngineVk platformEngine;
 #else
-        EngineGLFW engine;
+        EngineGLFW platformEngine;
 #endif
+        EngineNull nullEngine;
+        EngineSoftware softwareEngine;
+        BaseEngine* engine;
         
 		float lastTime;
 		bool autoDraw;
 
+		bool reactive;
+		float maxIdleInterval;
+		float wakeUpTime;
+		int settleFrames;
+		float updateInterval;
+		float nextUpdateTime;
+		bool isRedrawRequested;
+		bool isFrameSkipped;
+		bool threadedDraw;
+
 		BaseTheme* theme;
 
+#if !defined(OF_TARGET_API_VULKAN)
+		FrameCache frameCache;
+
+		// Changes to the cache made while threaded draw is on, run by the drawing thread that owns it
+		std::mutex frameCacheMutex;
+		std::vector<std::function<void()>> frameCacheUpdates;
+#endif
+
+		DrawDataHandoff drawHandoff;
+
+		// Threaded draw: the drawing thread publishes the stats it recorded after each frame
+		mutable std::mutex statsMutex;
+		RenderStats drawThreadStats;
+		mutable RenderStats threadedStats;      // returned by getStats()
+		DrawListProfiler drawListProfiler;
+		RemoteServer remoteServer;
+
 		std::vector<ofTexture*> loadedTextures;
 	};
 }
@@ -1,5 +1,7 @@
 #include "Helpers.h"
 
+#include "Tracer.h"
+
 //--------------------------------------------------------------
 ofxImGui::Settings::Settings()
 	: windowPos(kImGuiMargin, kImGuiMargin)
@@ -72,6 +74,9 @@ bool ofxImGui::BeginWindow(const std::string& name, Settings& settings, bool col
 	// Push a new list of names onto the stack.
 	windowOpen.usedNames.push(std::vector<std::string>());
 
+	// Traced until EndWindow()
+	ofxImGui::Tracer::begin(name);
+
 	ImGui::SetNextWindowPos(settings.windowPos, settings.lockPosition? ImGuiCond_Always : ImGuiCond_Appearing);
 	ImGui::SetNextWindowSize(settings.windowSize, ImGuiCond_Appearing);
 	ImGui::SetNextWindowCollapsed(collapse, ImGuiCond_Appearing);
@@ -92,6 +97,9 @@ bool ofxImGui::BeginWindow(const std::string& name, Settings& settings, ImGuiWin
 	// Push a new list of names onto the stack.
 	windowOpen.usedNames.push(std::vector<std::string>());
 
+	// Traced until EndWindow()
+	ofxImGui::Tracer::begin(name);
+
 	ImGui::SetNextWindowPos(settings.windowPos, settings.lockPosition? ImGuiCond_Always : ImGuiCond_Appearing);
 	ImGui::SetNextWindowSize(settings.windowSize, ImGuiCond_Appearing);
 	ImGui::SetNextWindowCollapsed(!(flags & ImGuiWindowFlags_NoCollapse), ImGuiCond_Appearing);
@@ -113,6 +121,7 @@ void ofxImGui::EndWindow(Settings& settings)
 	settings.windowSize = ImGui::GetWindowSize();
 	settings.mouseOverGui |= ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow);
 	ImGui::End();
+	ofxImGui::Tracer::end();
 
 	// Unlink the referenced ofParameter.
 	windowOpen.parameter.reset();
@@ -0,0 +1,756 @@
+#include "RemoteGui.h"
+
+#include "Gui.h"
+
+#include "ofAppRunner.h"
+#include "ofLog.h"
+#include "ofPixels.h"
+#include "ofUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(_WIN32)
+	typedef SOCKET SocketHandle;
+	const SocketHandle kInvalidSocket = INVALID_SOCKET;
+#else
+	typedef int SocketHandle;
+	const SocketHandle kInvalidSocket = -1;
+#endif
+
+	const size_t kHeaderSize = 2 * sizeof(uint32_t);
+	const uint32_t kMaxMessageSize = 256 * 1024 * 1024;
+	const size_t kReceiveChunk = 64 * 1024;
+
+	//--------------------------------------------------------------
+	SocketHandle toHandle(intptr_t socket)
+	{
+		return socket < 0 ? kInvalidSocket : (SocketHandle)socket;
+	}
+
+	//--------------------------------------------------------------
+	bool startSockets()
+	{
+#if defined(_WIN32)
+		static bool isStarted = false;
+		if (!isStarted)
+		{
+			WSADATA data;
+			isStarted = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		}
+		return isStarted;
+#else
+		return true;
+#endif
+	}
+
+	//--------------------------------------------------------------
+	void closeSocket(SocketHandle socket)
+	{
+#if defined(_WIN32)
+		closesocket(socket);
+#else
+		::close(socket);
+#endif
+	}
+
+	//--------------------------------------------------------------
+	void setNonBlocking(SocketHandle socket)
+	{
+#if defined(_WIN32)
+		u_long mode = 1;
+		ioctlsocket(socket, FIONBIO, &mode);
+#else
+		fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+#if defined(SO_NOSIGPIPE)
+		int enabled = 1;
+		setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, (const char*)&enabled, sizeof(enabled));
+#endif
+	}
+
+	//--------------------------------------------------------------
+	bool isWouldBlock()
+	{
+#if defined(_WIN32)
+		int error = WSAGetLastError();
+		return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS || errno == EINTR;
+#endif
+	}
+
+	//--------------------------------------------------------------
+	bool isWritable(SocketHandle socket)
+	{
+		fd_set set;
+		FD_ZERO(&set);
+		FD_SET(socket, &set);
+		timeval timeout = { 0, 0 };
+		return select((int)socket + 1, nullptr, &set, nullptr, &timeout) > 0;
+	}
+
+	//--------------------------------------------------------------
+	template<typename T>
+	void put(std::vector<unsigned char>& out, const T& value)
+	{
+		size_t offset = out.size();
+		out.resize(offset + sizeof(T));
+		memcpy(&out[offset], &value, sizeof(T));
+	}
+
+	//--------------------------------------------------------------
+	template<typename T>
+	void get(const std::vector<unsigned char>& in, size_t& pos, T& value)
+	{
+		memcpy(&value, &in[pos], sizeof(T));
+		pos += sizeof(T);
+	}
+
+	// Fields one by one, the struct layout may differ between the two ends
+	const size_t kInputEventSize = 1 + 4 * sizeof(float) + 3 * sizeof(int32_t) + sizeof(uint32_t);
+
+	//--------------------------------------------------------------
+	void writeInput(const ofxImGui::RemoteInputEvent& input, std::vector<unsigned char>& out)
+	{
+		put(out, input.type);
+		put(out, input.x);
+		put(out, input.y);
+		put(out, input.button);
+		put(out, input.scrollX);
+		put(out, input.scrollY);
+		put(out, input.key);
+		put(out, input.keycode);
+		put(out, input.codepoint);
+	}
+
+	//--------------------------------------------------------------
+	bool readInput(const std::vector<unsigned char>& in, ofxImGui::RemoteInputEvent& input)
+	{
+		if (in.size() != kInputEventSize)
+		{
+			return false;
+		}
+		size_t pos = 0;
+		get(in, pos, input.type);
+		get(in, pos, input.x);
+		get(in, pos, input.y);
+		get(in, pos, input.button);
+		get(in, pos, input.scrollX);
+		get(in, pos, input.scrollY);
+		get(in, pos, input.key);
+		get(in, pos, input.keycode);
+		get(in, pos, input.codepoint);
+		return true;
+	}
+}
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	bool RemoteConnection::connect(const std::string& host, int port)
+	{
+		close();
+		if (!startSockets())
+		{
+			return false;
+		}
+
+		addrinfo hints;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_STREAM;
+		addrinfo* address = nullptr;
+		if (getaddrinfo(host.c_str(), ofToString(port).c_str(), &hints, &address) != 0 || !address)
+		{
+			ofLogWarning("RemoteConnection") << "Cannot resolve " << host;
+			return false;
+		}
+
+		SocketHandle handle = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+		if (handle == kInvalidSocket)
+		{
+			freeaddrinfo(address);
+			return false;
+		}
+		setNonBlocking(handle);
+		int result = ::connect(handle, address->ai_addr, (int)address->ai_addrlen);
+		freeaddrinfo(address);
+		if (result != 0 && !isWouldBlock())
+		{
+			closeSocket(handle);
+			return false;
+		}
+
+		socket = (intptr_t)handle;
+		isConnecting = result != 0;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void RemoteConnection::adopt(intptr_t socket_)
+	{
+		if (socket_ != socket)
+		{
+			close();
+		}
+		socket = socket_;
+		isConnecting = false;
+		SocketHandle handle = toHandle(socket);
+		setNonBlocking(handle);
+		int enabled = 1;
+		setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, (const char*)&enabled, sizeof(enabled));
+	}
+
+	//--------------------------------------------------------------
+	void RemoteConnection::close()
+	{
+		if (socket >= 0)
+		{
+			closeSocket(toHandle(socket));
+			socket = -1;
+		}
+		isConnecting = false;
+		output.clear();
+		outputSent = 0;
+		input.clear();
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteConnection::isOpen() const
+	{
+		return socket >= 0;
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteConnection::isConnected() const
+	{
+		return socket >= 0 && !isConnecting;
+	}
+
+	//--------------------------------------------------------------
+	void RemoteConnection::update()
+	{
+		if (socket < 0)
+		{
+			return;
+		}
+		SocketHandle handle = toHandle(socket);
+
+		if (isConnecting)
+		{
+			if (!isWritable(handle))
+			{
+				return;
+			}
+			int error = 0;
+			socklen_t length = sizeof(error);
+			getsockopt(handle, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+			if (error != 0)
+			{
+				close();
+				return;
+			}
+			adopt(socket);
+		}
+
+		while (outputSent < output.size())
+		{
+#if defined(MSG_NOSIGNAL)
+			int flags = MSG_NOSIGNAL;
+#else
+			int flags = 0;
+#endif
+			int sent = (int)::send(handle, (const char*)&output[outputSent], (int)std::min(output.size() - outputSent, (size_t)1 << 20), flags);
+			if (sent <= 0)
+			{
+				if (sent < 0 && isWouldBlock())
+				{
+					break;
+				}
+				close();
+				return;
+			}
+			outputSent += sent;
+		}
+		if (outputSent == output.size())
+		{
+			output.clear();
+			outputSent = 0;
+		}
+
+		for (;;)
+		{
+			size_t offset = input.size();
+			input.resize(offset + kReceiveChunk);
+			int received = (int)::recv(handle, (char*)&input[offset], (int)kReceiveChunk, 0);
+			input.resize(offset + std::max(received, 0));
+			if (received <= 0)
+			{
+				if (received < 0 && isWouldBlock())
+				{
+					break;
+				}
+				// Closed by the other end
+				close();
+				return;
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void RemoteConnection::send(uint32_t type, const std::vector<unsigned char>& payload)
+	{
+		if (socket < 0)
+		{
+			return;
+		}
+		put(output, type);
+		put(output, (uint32_t)payload.size());
+		output.insert(output.end(), payload.begin(), payload.end());
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteConnection::hasPendingOutput() const
+	{
+		return outputSent < output.size();
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteConnection::receive(uint32_t& type, std::vector<unsigned char>& payload)
+	{
+		if (input.size() < kHeaderSize)
+		{
+			return false;
+		}
+		uint32_t size;
+		memcpy(&type, &input[0], sizeof(type));
+		memcpy(&size, &input[sizeof(type)], sizeof(size));
+		if (size > kMaxMessageSize)
+		{
+			ofLogWarning("RemoteConnection") << "Message of " << size << " bytes, closing the connection";
+			close();
+			return false;
+		}
+		if (input.size() < kHeaderSize + size)
+		{
+			return false;
+		}
+		payload.assign(input.begin() + kHeaderSize, input.begin() + kHeaderSize + size);
+		input.erase(input.begin(), input.begin() + kHeaderSize + size);
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteServer::setup(int port, const std::string& address)
+	{
+		exit();
+		if (!startSockets())
+		{
+			return false;
+		}
+
+		SocketHandle handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (handle == kInvalidSocket)
+		{
+			ofLogWarning("RemoteServer") << "Cannot create a socket";
+			return false;
+		}
+		int enabled = 1;
+		setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, (const char*)&enabled, sizeof(enabled));
+
+		sockaddr_in local;
+		memset(&local, 0, sizeof(local));
+		local.sin_family = AF_INET;
+		local.sin_port = htons((unsigned short)port);
+		if (inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1
+			|| bind(handle, (sockaddr*)&local, sizeof(local)) != 0
+			|| listen(handle, 1) != 0)
+		{
+			ofLogWarning("RemoteServer") << "Cannot listen on " << address << ":" << port;
+			closeSocket(handle);
+			return false;
+		}
+		setNonBlocking(handle);
+
+		listenSocket = (intptr_t)handle;
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void RemoteServer::exit()
+	{
+		connection.close();
+		if (listenSocket >= 0)
+		{
+			closeSocket(toHandle(listenSocket));
+			listenSocket = -1;
+		}
+		hasMouse = false;
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteServer::isSetup() const
+	{
+		return listenSocket >= 0;
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteServer::isConnected() const
+	{
+		return connection.isConnected();
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteServer::update(BaseEngine& engine)
+	{
+		if (listenSocket < 0)
+		{
+			return false;
+		}
+
+		SocketHandle accepted = accept(toHandle(listenSocket), nullptr, nullptr);
+		bool isNewViewer = accepted != kInvalidSocket;
+		if (isNewViewer)
+		{
+			ofLogNotice("RemoteServer") << "Viewer connected";
+			connection.adopt((intptr_t)accepted);
+			encoder.reset();
+			hasMouse = false;
+			sendFontAtlas();
+		}
+
+		connection.update();
+
+		uint32_t type;
+		while (connection.receive(type, message))
+		{
+			RemoteInputEvent input;
+			if (type == REMOTE_MESSAGE_INPUT && readInput(message, input))
+			{
+				applyInput(input, engine);
+			}
+		}
+		return isNewViewer;
+	}
+
+	//--------------------------------------------------------------
+	void RemoteServer::sendFrame(const ImDrawData * draw_data)
+	{
+		if (!connection.isConnected())
+		{
+			return;
+		}
+		connection.update();
+		if (connection.hasPendingOutput())
+		{
+			// The next frame is encoded against the last one sent, skipping is safe
+			return;
+		}
+		message.clear();
+		encoder.encode(draw_data, ImGui::GetIO().Fonts->TexID, message);
+		connection.send(REMOTE_MESSAGE_FRAME, message);
+		connection.update();
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteServer::hasMousePosition() const
+	{
+		return hasMouse && connection.isConnected();
+	}
+
+	//--------------------------------------------------------------
+	ImVec2 RemoteServer::getMousePosition() const
+	{
+		return mousePosition;
+	}
+
+	//--------------------------------------------------------------
+	void RemoteServer::sendFontAtlas()
+	{
+		unsigned char* pixels;
+		int width, height;
+		ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+		message.clear();
+		put(message, (uint32_t)width);
+		put(message, (uint32_t)height);
+		encodeDelta(pixels, (size_t)width * height * 4, nullptr, 0, message);
+		connection.send(REMOTE_MESSAGE_FONT_ATLAS, message);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteServer::applyInput(const RemoteInputEvent& input, BaseEngine& engine)
+	{
+		switch (input.type)
+		{
+		case RemoteInputEvent::MOUSE_MOVED:
+		case RemoteInputEvent::MOUSE_PRESSED:
+		case RemoteInputEvent::MOUSE_RELEASED:
+		case RemoteInputEvent::MOUSE_SCROLLED:
+		{
+			static const ofMouseEventArgs::Type types[] = { ofMouseEventArgs::Moved, ofMouseEventArgs::Pressed, ofMouseEventArgs::Released, ofMouseEventArgs::Scrolled };
+			ofMouseEventArgs event(types[input.type], input.x, input.y, input.button);
+			event.scrollX = input.scrollX;
+			event.scrollY = input.scrollY;
+			hasMouse = true;
+			mousePosition = ImVec2(input.x, input.y);
+
+			if (input.type == RemoteInputEvent::MOUSE_PRESSED) engine.onMousePressed(event);
+			else if (input.type == RemoteInputEvent::MOUSE_RELEASED) engine.onMouseReleased(event);
+			else if (input.type == RemoteInputEvent::MOUSE_SCROLLED) engine.onMouseScrolled(event);
+			engine.onMouseInput(event);
+			break;
+		}
+		case RemoteInputEvent::KEY_PRESSED:
+		case RemoteInputEvent::KEY_RELEASED:
+		{
+			if (input.keycode < 0 || input.keycode >= IM_ARRAYSIZE(ImGui::GetIO().KeysDown))
+			{
+				break;
+			}
+			ofKeyEventArgs event;
+			event.type = input.type == RemoteInputEvent::KEY_PRESSED ? ofKeyEventArgs::Pressed : ofKeyEventArgs::Released;
+			event.key = input.key;
+			event.keycode = input.keycode;
+			event.codepoint = input.codepoint;
+
+			if (event.type == ofKeyEventArgs::Pressed) engine.onKeyPressed(event);
+			else engine.onKeyReleased(event);
+			engine.onKeyInput(event);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::setup(Gui& gui_, const std::string& host_, int port_)
+	{
+		exit();
+		gui = &gui_;
+		host = host_;
+		port = port_;
+
+		ofAddListener(ofEvents().mouseMoved, this, &RemoteViewer::onMouseMoved);
+		ofAddListener(ofEvents().mouseDragged, this, &RemoteViewer::onMouseMoved);
+		ofAddListener(ofEvents().mousePressed, this, &RemoteViewer::onMousePressed);
+		ofAddListener(ofEvents().mouseReleased, this, &RemoteViewer::onMouseReleased);
+		ofAddListener(ofEvents().mouseScrolled, this, &RemoteViewer::onMouseScrolled);
+		ofAddListener(ofEvents().keyPressed, this, &RemoteViewer::onKeyPressed);
+		ofAddListener(ofEvents().keyReleased, this, &RemoteViewer::onKeyReleased);
+
+		lastConnectTime = ofGetElapsedTimef();
+		connection.connect(host, port);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::exit()
+	{
+		if (!gui) return;
+
+		ofRemoveListener(ofEvents().mouseMoved, this, &RemoteViewer::onMouseMoved);
+		ofRemoveListener(ofEvents().mouseDragged, this, &RemoteViewer::onMouseMoved);
+		ofRemoveListener(ofEvents().mousePressed, this, &RemoteViewer::onMousePressed);
+		ofRemoveListener(ofEvents().mouseReleased, this, &RemoteViewer::onMouseReleased);
+		ofRemoveListener(ofEvents().mouseScrolled, this, &RemoteViewer::onMouseScrolled);
+		ofRemoveListener(ofEvents().keyPressed, this, &RemoteViewer::onKeyPressed);
+		ofRemoveListener(ofEvents().keyReleased, this, &RemoteViewer::onKeyReleased);
+
+		connection.close();
+		decoder.reset();
+		frame.clear();
+		if (fontTexture)
+		{
+			gui->deleteTexture(fontTexture);
+			fontTexture = 0;
+		}
+		gui = nullptr;
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::update()
+	{
+		if (!gui) return;
+
+		if (!connection.isOpen())
+		{
+			float currentTime = ofGetElapsedTimef();
+			if (currentTime - lastConnectTime < 1.0f)
+			{
+				return;
+			}
+			lastConnectTime = currentTime;
+			connection.connect(host, port);
+		}
+
+		connection.update();
+
+		uint32_t type;
+		while (connection.receive(type, message))
+		{
+			if (type == REMOTE_MESSAGE_FONT_ATLAS)
+			{
+				loadFontAtlas(message);
+			}
+			else if (type == REMOTE_MESSAGE_FRAME && !decoder.decode(message.data(), message.size()))
+			{
+				// Reconnecting makes the server start over with a whole frame
+				ofLogWarning("RemoteViewer") << "Malformed frame, reconnecting";
+				connection.close();
+				break;
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::draw()
+	{
+		ImDrawData* draw_data = decoder.getDrawData();
+		if (!gui || !draw_data)
+		{
+			return;
+		}
+		frame.copyFrom(draw_data);
+
+		// Drawn one to one into this window, whatever the size of the server's
+		ImGuiIO& io = ImGui::GetIO();
+		ImDrawData* frame_data = frame.getDrawData();
+		frame_data->DisplaySize = io.DisplaySize;
+		frame_data->FramebufferScale = io.DisplayFramebufferScale;
+		gui->drawData(frame_data);
+	}
+
+	//--------------------------------------------------------------
+	bool RemoteViewer::isConnected() const
+	{
+		return connection.isConnected();
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::loadFontAtlas(const std::vector<unsigned char>& payload)
+	{
+		uint32_t width, height;
+		if (payload.size() < 2 * sizeof(uint32_t))
+		{
+			return;
+		}
+		size_t pos = 0;
+		get(payload, pos, width);
+		get(payload, pos, height);
+		if (width == 0 || height == 0 || width > 16384 || height > 16384)
+		{
+			return;
+		}
+
+		ofPixels pixels;
+		pixels.allocate(width, height, OF_PIXELS_RGBA);
+		if (decodeDelta(payload.data() + pos, payload.size() - pos, pixels.getData(), (size_t)width * height * 4, 0) == 0)
+		{
+			return;
+		}
+		if (fontTexture)
+		{
+			gui->deleteTexture(fontTexture);
+		}
+		fontTexture = gui->loadPixels(pixels);
+		decoder.setFontTexture((ImTextureID)(intptr_t)fontTexture);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::sendInput(const RemoteInputEvent& input)
+	{
+		if (!connection.isConnected())
+		{
+			return;
+		}
+		message.clear();
+		writeInput(input, message);
+		connection.send(REMOTE_MESSAGE_INPUT, message);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::onMouseMoved(ofMouseEventArgs& event)
+	{
+		RemoteInputEvent input;
+		input.type = RemoteInputEvent::MOUSE_MOVED;
+		input.x = event.x;
+		input.y = event.y;
+		sendInput(input);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::onMousePressed(ofMouseEventArgs& event)
+	{
+		RemoteInputEvent input;
+		input.type = RemoteInputEvent::MOUSE_PRESSED;
+		input.x = event.x;
+		input.y = event.y;
+		input.button = event.button;
+		sendInput(input);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::onMouseReleased(ofMouseEventArgs& event)
+	{
+		RemoteInputEvent input;
+		input.type = RemoteInputEvent::MOUSE_RELEASED;
+		input.x = event.x;
+		input.y = event.y;
+		input.button = event.button;
+		sendInput(input);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::onMouseScrolled(ofMouseEventArgs& event)
+	{
+		RemoteInputEvent input;
+		input.type = RemoteInputEvent::MOUSE_SCROLLED;
+		input.x = event.x;
+		input.y = event.y;
+		input.scrollX = event.scrollX;
+		input.scrollY = event.scrollY;
+		sendInput(input);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::onKeyPressed(ofKeyEventArgs& event)
+	{
+		RemoteInputEvent input;
+		input.type = RemoteInputEvent::KEY_PRESSED;
+		input.key = event.key;
+		input.keycode = event.keycode;
+		input.codepoint = event.codepoint;
+		sendInput(input);
+	}
+
+	//--------------------------------------------------------------
+	void RemoteViewer::onKeyReleased(ofKeyEventArgs& event)
+	{
+		RemoteInputEvent input;
+		input.type = RemoteInputEvent::KEY_RELEASED;
+		input.key = event.key;
+		input.keycode = event.keycode;
+		input.codepoint = event.codepoint;
+		sendInput(input);
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "BaseEngine.h"
+#include "DrawDataSnapshot.h"
+#include "DrawDataStream.h"
+
+#include "ofEvents.h"
+#include "imgui.h"
+
+#include <string>
+#include <vector>
+
+namespace ofxImGui
+{
+	class Gui;
+
+	const int kDefaultRemotePort = 7770;
+
+	// Input the viewer sends back, in the coordinates of the streamed GUI
+	struct RemoteInputEvent
+	{
+		enum Type
+		{
+			MOUSE_MOVED,
+			MOUSE_PRESSED,
+			MOUSE_RELEASED,
+			MOUSE_SCROLLED,
+			KEY_PRESSED,
+			KEY_RELEASED
+		};
+
+		uint8_t type = MOUSE_MOVED;
+		float x = 0.0f;
+		float y = 0.0f;
+		int32_t button = 0;
+		float scrollX = 0.0f;
+		float scrollY = 0.0f;
+		int32_t key = 0;
+		int32_t keycode = 0;
+		uint32_t codepoint = 0;
+	};
+
+	// Non-blocking TCP connection carrying RemoteMessageType messages
+	class RemoteConnection
+	{
+	public:
+		~RemoteConnection()
+		{
+			close();
+		}
+
+		// Starts connecting, update() finishes it
+		bool connect(const std::string& host, int port);
+		void adopt(intptr_t socket);
+		void close();
+
+		bool isOpen() const;
+		bool isConnected() const;
+
+		// Sends what the socket takes and reads what arrived, closes the connection on errors
+		void update();
+
+		void send(uint32_t type, const std::vector<unsigned char>& payload);
+		bool hasPendingOutput() const;
+
+		// Takes the next complete message
+		bool receive(uint32_t& type, std::vector<unsigned char>& payload);
+
+	private:
+		intptr_t socket = -1;
+		bool isConnecting = false;
+		std::vector<unsigned char> output;
+		size_t outputSent = 0;
+		std::vector<unsigned char> input;
+	};
+
+	// Streams the frames of a Gui to one RemoteViewer at a time and applies the input it sends back.
+	// Used by Gui::setRemoteStreaming().
+	class RemoteServer
+	{
+	public:
+		~RemoteServer()
+		{
+			exit();
+		}
+
+		// Listens on the loopback interface unless an other address is given, "0.0.0.0" for all
+		bool setup(int port = kDefaultRemotePort, const std::string& address = "127.0.0.1");
+		void exit();
+
+		bool isSetup() const;
+		bool isConnected() const;
+
+		// Accepts a new viewer, which replaces the current one, and feeds its input to engine.
+		// Returns true when a viewer connected, it waits for the next frame.
+		bool update(BaseEngine& engine);
+
+		// Frames are skipped while the viewer has not taken the previous one
+		void sendFrame(const ImDrawData * draw_data);
+
+		// Where the viewer's mouse is, once it moved over the streamed GUI
+		bool hasMousePosition() const;
+		ImVec2 getMousePosition() const;
+
+	private:
+		void sendFontAtlas();
+		void applyInput(const RemoteInputEvent& input, BaseEngine& engine);
+
+		intptr_t listenSocket = -1;
+		RemoteConnection connection;
+		DrawDataEncoder encoder;
+		std::vector<unsigned char> message;
+		bool hasMouse = false;
+		ImVec2 mousePosition;
+	};
+
+	// Shows the frames of a RemoteServer with the engine of a local Gui, which needs no widgets
+	// of its own, and sends the mouse and keyboard input of this window back.
+	// Only the font atlas is streamed, images of the remote GUI are left out.
+	// Not available with Vulkan, which cannot draw a given ImDrawData.
+	class RemoteViewer
+	{
+	public:
+		~RemoteViewer()
+		{
+			exit();
+		}
+
+		void setup(Gui& gui, const std::string& host = "127.0.0.1", int port = kDefaultRemotePort);
+		void exit();
+
+		// Receives frames, reconnects every second when the server is not there
+		void update();
+		void draw();
+
+		bool isConnected() const;
+
+		void onMouseMoved(ofMouseEventArgs& event);
+		void onMousePressed(ofMouseEventArgs& event);
+		void onMouseReleased(ofMouseEventArgs& event);
+		void onMouseScrolled(ofMouseEventArgs& event);
+		void onKeyPressed(ofKeyEventArgs& event);
+		void onKeyReleased(ofKeyEventArgs& event);
+
+	private:
+		void sendInput(const RemoteInputEvent& input);
+		void loadFontAtlas(const std::vector<unsigned char>& payload);
+
+		Gui* gui = nullptr;
+		std::string host;
+		int port = kDefaultRemotePort;
+		float lastConnectTime = 0.0f;
+
+		RemoteConnection connection;
+		DrawDataDecoder decoder;
+		DrawDataSnapshot frame;         // drawn instead of the decoded frame, with this window's display size
+		GLuint fontTexture = 0;         // atlas of the server, replaced when it sends another
+		std::vector<unsigned char> message;
+	};
+}
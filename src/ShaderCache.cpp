@@ -0,0 +1,387 @@
+#include "ShaderCache.h"
+
+#if !defined(OF_TARGET_API_VULKAN)
+
+#include "ofFileUtils.h"
+#include "ofGLUtils.h"
+#include "ofLog.h"
+#include "ofUtils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#if defined(TARGET_OPENGLES) && !defined(TARGET_OF_IOS)
+#include <EGL/egl.h>
+#elif !defined(TARGET_OPENGLES)
+#include "GLFW/glfw3.h"
+#endif
+
+// Not declared by the ES 2 headers, same values as GL_OES_get_program_binary
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace
+{
+#if defined(TARGET_OPENGLES)
+	typedef void (GL_APIENTRY *GetProgramBinaryFn)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+	typedef void (GL_APIENTRY *ProgramBinaryFn)(GLuint program, GLenum binaryFormat, const void* binary, GLint length);
+	typedef void (GL_APIENTRY *MaxShaderCompilerThreadsFn)(GLuint count);
+
+	GetProgramBinaryFn getProgramBinary = nullptr;
+	ProgramBinaryFn programBinary = nullptr;
+#else
+	typedef void (GLAPIENTRY *MaxShaderCompilerThreadsFn)(GLuint count);
+#endif
+	MaxShaderCompilerThreadsFn maxShaderCompilerThreads = nullptr;
+
+	const char kBinaryMagic[4] = { 'I', 'G', 'P', 'B' };
+
+	//--------------------------------------------------------------
+	uint64_t hashString(uint64_t hash, const std::string& str)
+	{
+		// FNV-1a, stable across runs unlike std::hash
+		for (unsigned char c : str)
+		{
+			hash = (hash ^ c) * 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	//--------------------------------------------------------------
+	std::string getGLString(GLenum name)
+	{
+		const GLubyte* str = glGetString(name);
+		return str ? std::string((const char*)str) : std::string();
+	}
+
+	//--------------------------------------------------------------
+	void* getProcAddress(const char* name)
+	{
+#if defined(TARGET_OF_IOS) || defined(TARGET_EMSCRIPTEN)
+		return nullptr;
+#elif defined(TARGET_OPENGLES)
+		return (void*)eglGetProcAddress(name);
+#else
+		return (void*)glfwGetProcAddress(name);
+#endif
+	}
+
+	//--------------------------------------------------------------
+	void enableParallelCompile()
+	{
+		static bool isLoaded = false;
+		if (!isLoaded)
+		{
+			isLoaded = true;
+			if (ofGLCheckExtension("GL_KHR_parallel_shader_compile"))
+			{
+				maxShaderCompilerThreads = (MaxShaderCompilerThreadsFn)getProcAddress("glMaxShaderCompilerThreadsKHR");
+			}
+			else if (ofGLCheckExtension("GL_ARB_parallel_shader_compile"))
+			{
+				maxShaderCompilerThreads = (MaxShaderCompilerThreadsFn)getProcAddress("glMaxShaderCompilerThreadsARB");
+			}
+		}
+		if (maxShaderCompilerThreads)
+		{
+			// Let the driver pick the number of threads
+			maxShaderCompilerThreads(0xFFFFFFFF);
+		}
+	}
+
+	//--------------------------------------------------------------
+	GLuint compileShader(GLenum type, const std::string& source)
+	{
+		GLuint shader = glCreateShader(type);
+		const GLchar* source_ptr = source.c_str();
+		glShaderSource(shader, 1, &source_ptr, 0);
+		glCompileShader(shader);
+		return shader;
+	}
+}
+
+namespace ofxImGui
+{
+	bool ShaderCache::g_Enabled = false;
+	bool ShaderCache::g_ParallelCompile = false;
+	std::string ShaderCache::g_Directory;
+	std::vector<std::pair<GLuint, std::string>> ShaderCache::g_PendingPrograms;
+
+	//--------------------------------------------------------------
+	void ShaderCache::setEnabled(bool enabled)
+	{
+		g_Enabled = enabled;
+	}
+
+	//--------------------------------------------------------------
+	bool ShaderCache::isEnabled()
+	{
+		return g_Enabled;
+	}
+
+	//--------------------------------------------------------------
+	void ShaderCache::setDirectory(const std::string& directory)
+	{
+		g_Directory = directory;
+	}
+
+	//--------------------------------------------------------------
+	std::string ShaderCache::getDirectory()
+	{
+		return g_Directory.empty() ? ofToDataPath("imgui_shader_cache", true) : g_Directory;
+	}
+
+	//--------------------------------------------------------------
+	void ShaderCache::setParallelCompile(bool enabled)
+	{
+		g_ParallelCompile = enabled;
+	}
+
+	//--------------------------------------------------------------
+	bool ShaderCache::isParallelCompile()
+	{
+		return g_ParallelCompile;
+	}
+
+	//--------------------------------------------------------------
+	bool ShaderCache::isBinarySupported()
+	{
+#if defined(TARGET_OF_IOS) || defined(TARGET_EMSCRIPTEN)
+		return false;
+#else
+		static int isSupported = -1;
+		if (isSupported < 0)
+		{
+#if defined(TARGET_OPENGLES)
+			if (ofGLCheckExtension("GL_OES_get_program_binary"))
+			{
+				getProgramBinary = (GetProgramBinaryFn)getProcAddress("glGetProgramBinaryOES");
+				programBinary = (ProgramBinaryFn)getProcAddress("glProgramBinaryOES");
+			}
+			bool hasFunctions = getProgramBinary && programBinary;
+#else
+			bool hasFunctions = glGetProgramBinary && glProgramBinary && glProgramParameteri;
+#endif
+			// Some drivers expose the functions but no format to store programs in
+			GLint num_formats = 0;
+			if (hasFunctions)
+			{
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+			}
+			isSupported = num_formats > 0 ? 1 : 0;
+		}
+		return isSupported == 1;
+#endif
+	}
+
+	//--------------------------------------------------------------
+	std::string ShaderCache::getProgramPath(const std::string& vertex_shader, const std::string& fragment_shader, const AttribLocations& attrib_locations)
+	{
+		uint64_t hash = 14695981039346656037ULL;
+		hash = hashString(hash, getGLString(GL_VENDOR));
+		hash = hashString(hash, getGLString(GL_RENDERER));
+		hash = hashString(hash, getGLString(GL_VERSION));
+		hash = hashString(hash, vertex_shader);
+		hash = hashString(hash, fragment_shader);
+		for (const auto& attrib : attrib_locations)
+		{
+			hash = hashString(hash, ofToString(attrib.first) + attrib.second);
+		}
+
+		std::ostringstream name;
+		name << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+		return ofFilePath::join(getDirectory(), name.str());
+	}
+
+	//--------------------------------------------------------------
+	GLuint ShaderCache::createProgram(const std::string& vertex_shader, const std::string& fragment_shader, const AttribLocations& attrib_locations)
+	{
+		std::string path;
+		if (g_Enabled && isBinarySupported())
+		{
+			path = getProgramPath(vertex_shader, fragment_shader, attrib_locations);
+			GLuint program = loadProgram(path);
+			if (program)
+			{
+				return program;
+			}
+		}
+
+		if (g_ParallelCompile)
+		{
+			enableParallelCompile();
+		}
+
+		GLuint program = glCreateProgram();
+		GLuint vert_handle = compileShader(GL_VERTEX_SHADER, vertex_shader);
+		GLuint frag_handle = compileShader(GL_FRAGMENT_SHADER, fragment_shader);
+		glAttachShader(program, vert_handle);
+		glAttachShader(program, frag_handle);
+		for (const auto& attrib : attrib_locations)
+		{
+			glBindAttribLocation(program, attrib.first, attrib.second.c_str());
+		}
+#if !defined(TARGET_OPENGLES)
+		if (!path.empty())
+		{
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+#endif
+		glLinkProgram(program);
+
+		// The program keeps what it needs, the shaders can go once it is linked
+		glDetachShader(program, vert_handle);
+		glDetachShader(program, frag_handle);
+		glDeleteShader(vert_handle);
+		glDeleteShader(frag_handle);
+
+		g_PendingPrograms.emplace_back(program, path);
+		return program;
+	}
+
+	//--------------------------------------------------------------
+	bool ShaderCache::finishProgram(GLuint program)
+	{
+		auto it = std::find_if(g_PendingPrograms.begin(), g_PendingPrograms.end(), [program](const std::pair<GLuint, std::string>& pending) {
+			return pending.first == program;
+		});
+		if (it == g_PendingPrograms.end())
+		{
+			// Loaded from a binary, which was already checked
+			return program != 0;
+		}
+		std::string path = it->second;
+		g_PendingPrograms.erase(it);
+
+		GLint status = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (!status)
+		{
+			GLint length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+			std::string info(std::max(length, 1), '\0');
+			glGetProgramInfoLog(program, length, nullptr, &info[0]);
+			ofLogError("ShaderCache") << "Could not link program: " << info.c_str();
+			return false;
+		}
+
+		if (!path.empty())
+		{
+			storeProgram(program, path);
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	GLuint ShaderCache::loadProgram(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return 0;
+		}
+
+		char magic[sizeof(kBinaryMagic)];
+		uint32_t format = 0;
+		file.read(magic, sizeof(magic));
+		file.read((char*)&format, sizeof(format));
+		if (!file || !std::equal(magic, magic + sizeof(magic), kBinaryMagic))
+		{
+			ofLogWarning("ShaderCache") << "Ignoring invalid program binary " << path;
+			return 0;
+		}
+		std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (binary.empty())
+		{
+			ofLogWarning("ShaderCache") << "Ignoring invalid program binary " << path;
+			return 0;
+		}
+
+		GLuint program = glCreateProgram();
+#if defined(TARGET_OPENGLES)
+		programBinary(program, format, binary.data(), (GLint)binary.size());
+#else
+		glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+#endif
+
+		// The driver can reject binaries, e.g. after an update that kept the version string
+		GLint status = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (!status)
+		{
+			glDeleteProgram(program);
+			ofFile::removeFile(path, false);
+			ofLogVerbose("ShaderCache") << "Stale program binary " << path << ", compiling from source";
+			return 0;
+		}
+
+		ofLogVerbose("ShaderCache") << "Loaded program binary " << path;
+		return program;
+	}
+
+	//--------------------------------------------------------------
+	void ShaderCache::storeProgram(GLuint program, const std::string& path)
+	{
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+		{
+			return;
+		}
+
+		std::vector<char> binary(length);
+		GLenum format = 0;
+#if defined(TARGET_OPENGLES)
+		getProgramBinary(program, length, &length, &format, binary.data());
+#else
+		glGetProgramBinary(program, length, &length, &format, binary.data());
+#endif
+
+		ofDirectory::createDirectory(getDirectory(), false, true);
+
+		// Written under another name first, so other instances starting at the same time never read a partial file
+		std::string tmp_path = path + "." + ofToString(ofGetSystemTimeMicros()) + ".tmp";
+		{
+			std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+			uint32_t format_out = format;
+			file.write(kBinaryMagic, sizeof(kBinaryMagic));
+			file.write((const char*)&format_out, sizeof(format_out));
+			file.write(binary.data(), length);
+			if (!file)
+			{
+				ofLogWarning("ShaderCache") << "Could not write program binary " << path;
+				file.close();
+				ofFile::removeFile(tmp_path, false);
+				return;
+			}
+		}
+		if (!ofFile::moveFromTo(tmp_path, path, false, true))
+		{
+			ofFile::removeFile(tmp_path, false);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void ShaderCache::clear()
+	{
+		ofDirectory dir(getDirectory());
+		if (!dir.exists())
+		{
+			return;
+		}
+		dir.allowExt("bin");
+		dir.listDir();
+		for (auto& file : dir)
+		{
+			file.remove();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ofConstants.h"
+#if !defined(OF_TARGET_API_VULKAN)
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ofxImGui
+{
+	// Links the GLSL programs of the backends and keeps their binaries on disk, so later
+	// runs on the same driver skip compiling. Binaries are looked up by driver and source,
+	// after a driver update or a shader change the program is simply compiled again.
+	class ShaderCache
+	{
+	public:
+		typedef std::vector<std::pair<GLuint, std::string>> AttribLocations;
+
+		// Both need to be set before Gui::setup()
+		static void setEnabled(bool enabled);
+		static bool isEnabled();
+
+		// Defaults to imgui_shader_cache in the data folder
+		static void setDirectory(const std::string& directory);
+		static std::string getDirectory();
+
+		// Lets the driver compile on its own threads when it supports GL_KHR_parallel_shader_compile.
+		// Programs then link in the background until finishProgram() is called on them, the engines
+		// call it at the end of their setup so linking overlaps building the font atlas.
+		static void setParallelCompile(bool enabled);
+		static bool isParallelCompile();
+
+		// Starts linking a program from a stored binary or from source, without waiting for the result
+		static GLuint createProgram(const std::string& vertex_shader, const std::string& fragment_shader, const AttribLocations& attrib_locations = AttribLocations());
+
+		// Waits for the link to complete, logs errors and stores the binary of a program compiled from source
+		static bool finishProgram(GLuint program);
+
+		// Deletes the stored binaries
+		static void clear();
+
+	private:
+		static bool isBinarySupported();
+		static std::string getProgramPath(const std::string& vertex_shader, const std::string& fragment_shader, const AttribLocations& attrib_locations);
+		static GLuint loadProgram(const std::string& path);
+		static void storeProgram(GLuint program, const std::string& path);
+
+		static bool g_Enabled;
+		static bool g_ParallelCompile;
+		static std::string g_Directory;
+		static std::vector<std::pair<GLuint, std::string>> g_PendingPrograms;  // compiled from source, with the path to store them at
+	};
+}
+
+#endif
@@ -0,0 +1,846 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFXIMGUI_RASTERIZER_SSE2
+#endif
+
+namespace
+{
+	const int kTileSize = 64;       // multiple of 4, rows are walked four pixels at a time
+	const float kCoverageMargin = 1.0f / 256.0f;   // in pixels
+
+	// Four pixels of a row
+#if defined(OFXIMGUI_RASTERIZER_SSE2)
+	struct Float4
+	{
+		__m128 v;
+
+		Float4(__m128 v_) : v(v_) {}
+		explicit Float4(float f) : v(_mm_set1_ps(f)) {}
+
+		static Float4 ramp(float start) { return _mm_setr_ps(start, start + 1.0f, start + 2.0f, start + 3.0f); }
+
+		Float4 operator+(const Float4& o) const { return _mm_add_ps(v, o.v); }
+		Float4 operator-(const Float4& o) const { return _mm_sub_ps(v, o.v); }
+		Float4 operator*(const Float4& o) const { return _mm_mul_ps(v, o.v); }
+		void store(float* out) const { _mm_storeu_ps(out, v); }
+	};
+
+	// Bit per lane inside the edge, pixels exactly on a top or left edge belong to the triangle
+	inline int edgeMask(const Float4& w, bool is_top_left)
+	{
+		__m128 zero = _mm_setzero_ps();
+		return _mm_movemask_ps(is_top_left ? _mm_cmpge_ps(w.v, zero) : _mm_cmpgt_ps(w.v, zero));
+	}
+#else
+	struct Float4
+	{
+		float v[4];
+
+		Float4() {}
+		explicit Float4(float f) { v[0] = v[1] = v[2] = v[3] = f; }
+
+		static Float4 ramp(float start) { Float4 r; for (int i = 0; i < 4; i++) r.v[i] = start + (float)i; return r; }
+
+		Float4 operator+(const Float4& o) const { Float4 r; for (int i = 0; i < 4; i++) r.v[i] = v[i] + o.v[i]; return r; }
+		Float4 operator-(const Float4& o) const { Float4 r; for (int i = 0; i < 4; i++) r.v[i] = v[i] - o.v[i]; return r; }
+		Float4 operator*(const Float4& o) const { Float4 r; for (int i = 0; i < 4; i++) r.v[i] = v[i] * o.v[i]; return r; }
+		void store(float* out) const { memcpy(out, v, sizeof(v)); }
+	};
+
+	inline int edgeMask(const Float4& w, bool is_top_left)
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (is_top_left ? w.v[i] >= 0.0f : w.v[i] > 0.0f) mask |= 1 << i;
+		}
+		return mask;
+	}
+#endif
+
+	// Pixels are RGBA bytes, read as little endian words
+	inline uint32_t packColor(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+	{
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	inline uint32_t div255(uint32_t x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	inline void blendPixel(uint32_t& dst, uint32_t src, bool premultiplied_alpha)
+	{
+		uint32_t a = src >> 24;
+		if (a == 255)
+		{
+			dst = src;
+			return;
+		}
+		if (a == 0)
+		{
+			return;
+		}
+		uint32_t inv_a = 255 - a;
+		uint32_t d = dst;
+		uint32_t r = div255((src & 0xFF) * a + (d & 0xFF) * inv_a);
+		uint32_t g = div255(((src >> 8) & 0xFF) * a + ((d >> 8) & 0xFF) * inv_a);
+		uint32_t b = div255(((src >> 16) & 0xFF) * a + ((d >> 16) & 0xFF) * inv_a);
+		// Same as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA), or GL_ONE for alpha when premultiplied
+		uint32_t out_a = div255((premultiplied_alpha ? a * 255 : a * a) + (d >> 24) * inv_a);
+		dst = packColor(r, g, b, out_a);
+	}
+
+#if defined(OFXIMGUI_RASTERIZER_SSE2)
+	// blendPixel() of one color over four pixels, src_terms holds the source side of the
+	// blend equation per channel, twice. Every sum fits 16 bits as a + inv_a is 255.
+	inline void blendPixels4(uint32_t* dst, __m128i src_terms, __m128i inv_alpha)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i bias = _mm_set1_epi16(128);
+		__m128i d = _mm_loadu_si128((const __m128i*)dst);
+		__m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv_alpha), src_terms), bias);
+		__m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv_alpha), src_terms), bias);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+		_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+	}
+
+	inline __m128i blendTerms(uint32_t color, bool premultiplied_alpha)
+	{
+		uint32_t a = color >> 24;
+		short r = (short)((color & 0xFF) * a);
+		short g = (short)(((color >> 8) & 0xFF) * a);
+		short b = (short)(((color >> 16) & 0xFF) * a);
+		short alpha = (short)(premultiplied_alpha ? a * 255 : a * a);
+		return _mm_setr_epi16(r, g, b, alpha, r, g, b, alpha);
+	}
+#endif
+
+	inline void unpackVertexColor(ImU32 col, float out[4])
+	{
+		out[0] = (float)((col >> IM_COL32_R_SHIFT) & 0xFF);
+		out[1] = (float)((col >> IM_COL32_G_SHIFT) & 0xFF);
+		out[2] = (float)((col >> IM_COL32_B_SHIFT) & 0xFF);
+		out[3] = (float)((col >> IM_COL32_A_SHIFT) & 0xFF);
+	}
+
+	inline uint32_t vertexColor(ImU32 col)
+	{
+		return packColor((col >> IM_COL32_R_SHIFT) & 0xFF, (col >> IM_COL32_G_SHIFT) & 0xFF, (col >> IM_COL32_B_SHIFT) & 0xFF, (col >> IM_COL32_A_SHIFT) & 0xFF);
+	}
+
+	// std::floor and std::ceil are library calls without SSE4.1, the values here are small
+	inline int floorToInt(float f)
+	{
+		int i = (int)f;
+		return i - (f < (float)i ? 1 : 0);
+	}
+
+	inline int ceilToInt(float f)
+	{
+		int i = (int)f;
+		return i + (f > (float)i ? 1 : 0);
+	}
+
+	inline uint32_t toByte(float f)
+	{
+		return (uint32_t)std::min(std::max(f + 0.5f, 0.0f), 255.0f);
+	}
+}
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	template<typename TextureT>
+	static uint32_t sampleBilinear(const TextureT* texture, float u, float v)
+	{
+		if (!texture || texture->texels.empty())
+		{
+			return 0xFFFFFFFF;
+		}
+		float x = u * texture->width - 0.5f;
+		float y = v * texture->height - 0.5f;
+		int ix = floorToInt(std::min(std::max(x, -1.0f), (float)texture->width));
+		int iy = floorToInt(std::min(std::max(y, -1.0f), (float)texture->height));
+		float fx = x - (float)ix;
+		float fy = y - (float)iy;
+		int x0 = std::min(std::max(ix, 0), texture->width - 1);
+		int y0 = std::min(std::max(iy, 0), texture->height - 1);
+
+		// Glyphs drawn at their size sample texel centers
+		const uint32_t* row0 = &texture->texels[y0 * texture->width];
+		if (fx == 0.0f && fy == 0.0f)
+		{
+			return row0[x0];
+		}
+		int x1 = std::min(std::max(ix + 1, 0), texture->width - 1);
+		int y1 = std::min(std::max(iy + 1, 0), texture->height - 1);
+		const uint32_t* row1 = &texture->texels[y1 * texture->width];
+		uint32_t t00 = row0[x0], t10 = row0[x1], t01 = row1[x0], t11 = row1[x1];
+
+		float w00 = (1.0f - fx) * (1.0f - fy);
+		float w10 = fx * (1.0f - fy);
+		float w01 = (1.0f - fx) * fy;
+		float w11 = fx * fy;
+		uint32_t out = 0;
+		for (int c = 0; c < 4; c++)
+		{
+			int shift = c * 8;
+			float value = ((t00 >> shift) & 0xFF) * w00 + ((t10 >> shift) & 0xFF) * w10 + ((t01 >> shift) & 0xFF) * w01 + ((t11 >> shift) & 0xFF) * w11;
+			out |= toByte(value) << shift;
+		}
+		return out;
+	}
+
+	//--------------------------------------------------------------
+	static uint32_t modulate(uint32_t color, uint32_t texel)
+	{
+		return packColor(div255((color & 0xFF) * (texel & 0xFF)), div255(((color >> 8) & 0xFF) * ((texel >> 8) & 0xFF)),
+			div255(((color >> 16) & 0xFF) * ((texel >> 16) & 0xFF)), div255((color >> 24) * (texel >> 24)));
+	}
+
+	//--------------------------------------------------------------
+	SoftwareRasterizer::SoftwareRasterizer()
+		: premultipliedAlpha(false)
+		, threadCount(0)
+		, target(nullptr)
+		, targetWidth(0)
+		, targetHeight(0)
+		, tilesX(0)
+		, tilesY(0)
+		, generation(0)
+		, busyWorkers(0)
+		, isQuitting(false)
+		, nextTile(0)
+	{
+	}
+
+	//--------------------------------------------------------------
+	SoftwareRasterizer::~SoftwareRasterizer()
+	{
+		stopWorkers();
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::setThreadCount(int count)
+	{
+		if (count != threadCount)
+		{
+			stopWorkers();
+			threadCount = count;
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::setPremultipliedAlpha(bool enabled)
+	{
+		premultipliedAlpha = enabled;
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::setTexture(ImTextureID textureId, const unsigned char * pixels, int width, int height)
+	{
+		Texture& texture = textures[textureId];
+		texture.width = width;
+		texture.height = height;
+		texture.texels.resize((size_t)width * height);
+		memcpy(texture.texels.data(), pixels, texture.texels.size() * sizeof(uint32_t));
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::removeTexture(ImTextureID textureId)
+	{
+		textures.erase(textureId);
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::render(const ImDrawData * draw_data, unsigned char * pixels, int width, int height, const ImVec2& scale)
+	{
+		if (!draw_data || !draw_data->Valid || width <= 0 || height <= 0)
+		{
+			return;
+		}
+
+		target = pixels;
+		targetWidth = width;
+		targetHeight = height;
+		tilesX = (width + kTileSize - 1) / kTileSize;
+		tilesY = (height + kTileSize - 1) / kTileSize;
+		if ((int)tileBins.size() < tilesX * tilesY)
+		{
+			tileBins.resize(tilesX * tilesY);
+		}
+		for (auto& bin : tileBins)
+		{
+			bin.clear();
+		}
+		primitives.clear();
+
+		// Set up all triangles and sort them into the tiles they touch, in draw order
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* cmd_list = draw_data->CmdLists[n];
+			const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
+
+			for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+			{
+				const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+				if (!pcmd->UserCallback)
+				{
+					int clip[4] = {
+						std::max((int)((pcmd->ClipRect.x - draw_data->DisplayPos.x) * scale.x), 0),
+						std::max((int)((pcmd->ClipRect.y - draw_data->DisplayPos.y) * scale.y), 0),
+						std::min((int)((pcmd->ClipRect.z - draw_data->DisplayPos.x) * scale.x), width),
+						std::min((int)((pcmd->ClipRect.w - draw_data->DisplayPos.y) * scale.y), height)
+					};
+					if (clip[0] < clip[2] && clip[1] < clip[3])
+					{
+						auto it = textures.find(pcmd->TextureId);
+						const Texture* texture = it != textures.end() ? &it->second : nullptr;
+						const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data + pcmd->VtxOffset;
+						unsigned int i = 0;
+						while (i + 2 < pcmd->ElemCount)
+						{
+							if (i + 5 < pcmd->ElemCount && setupRectangle(vtx_buffer, idx_buffer + i, clip, texture, draw_data->DisplayPos, scale))
+							{
+								i += 6;
+								continue;
+							}
+							setupTriangle(vtx_buffer[idx_buffer[i]], vtx_buffer[idx_buffer[i + 1]], vtx_buffer[idx_buffer[i + 2]], clip, texture, draw_data->DisplayPos, scale);
+							i += 3;
+						}
+					}
+				}
+				idx_buffer += pcmd->ElemCount;
+			}
+		}
+
+		if (primitives.empty())
+		{
+			return;
+		}
+
+		if (workers.empty())
+		{
+			startWorkers();
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			nextTile = 0;
+			busyWorkers = (int)workers.size();
+			generation++;
+		}
+		startCondition.notify_all();
+		runTiles();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			doneCondition.wait(lock, [this]() { return busyWorkers == 0; });
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::setupTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2, const int clip[4], const Texture * texture, const ImVec2& offset, const ImVec2& scale)
+	{
+		const ImDrawVert* verts[3] = { &v0, &v1, &v2 };
+		ImVec2 pos[3];
+		for (int i = 0; i < 3; i++)
+		{
+			pos[i] = ImVec2((verts[i]->pos.x - offset.x) * scale.x, (verts[i]->pos.y - offset.y) * scale.y);
+		}
+
+		float area = (pos[1].x - pos[0].x) * (pos[2].y - pos[0].y) - (pos[1].y - pos[0].y) * (pos[2].x - pos[0].x);
+		if (area == 0.0f || std::isnan(area))
+		{
+			return;
+		}
+		if (area < 0.0f)
+		{
+			// No culling, flip to a common winding
+			std::swap(pos[1], pos[2]);
+			std::swap(verts[1], verts[2]);
+			area = -area;
+		}
+
+		float min_x = std::min(pos[0].x, std::min(pos[1].x, pos[2].x));
+		float max_x = std::max(pos[0].x, std::max(pos[1].x, pos[2].x));
+		float min_y = std::min(pos[0].y, std::min(pos[1].y, pos[2].y));
+		float max_y = std::max(pos[0].y, std::max(pos[1].y, pos[2].y));
+
+		// Pixels whose center is within the bounds, clamped before converting to int
+		Primitive tri;
+		tri.isRect = false;
+		tri.minX = std::max((int)std::ceil(std::max(min_x - 0.5f, -1.0f)), clip[0]);
+		tri.maxX = std::min((int)std::floor(std::min(max_x - 0.5f, (float)clip[2])) + 1, clip[2]);
+		tri.minY = std::max((int)std::ceil(std::max(min_y - 0.5f, -1.0f)), clip[1]);
+		tri.maxY = std::min((int)std::floor(std::min(max_y - 0.5f, (float)clip[3])) + 1, clip[3]);
+		if (tri.minX >= tri.maxX || tri.minY >= tri.maxY)
+		{
+			return;
+		}
+
+		// Edge i is opposite vertex i. Each edge is evaluated from its lower vertex, so two triangles
+		// sharing it compute exactly negated values and the top-left rule gives its pixels to one of them.
+		for (int i = 0; i < 3; i++)
+		{
+			const ImVec2& a = pos[(i + 1) % 3];
+			const ImVec2& b = pos[(i + 2) % 3];
+			bool is_ordered = a.x < b.x || (a.x == b.x && a.y < b.y);
+			const ImVec2& c0 = is_ordered ? a : b;
+			const ImVec2& c1 = is_ordered ? b : a;
+			float sign = is_ordered ? 1.0f : -1.0f;
+			tri.originX[i] = c0.x;
+			tri.originY[i] = c0.y;
+			tri.edgeA[i] = -sign * (c1.y - c0.y);
+			tri.edgeB[i] = sign * (c1.x - c0.x);
+			tri.isTopLeft[i] = tri.edgeA[i] > 0.0f || (tri.edgeA[i] == 0.0f && tri.edgeB[i] > 0.0f);
+			tri.invEdgeA[i] = tri.edgeA[i] != 0.0f ? 1.0f / tri.edgeA[i] : 0.0f;
+		}
+		tri.invArea = 1.0f / area;
+
+		for (int i = 0; i < 3; i++)
+		{
+			tri.uv[i] = verts[i]->uv;
+			unpackVertexColor(verts[i]->col, tri.color[i]);
+		}
+		tri.texture = texture;
+		tri.flatColor = 0;
+		tri.isFlat = v0.col == v1.col && v0.col == v2.col
+			&& v0.uv.x == v1.uv.x && v0.uv.x == v2.uv.x && v0.uv.y == v1.uv.y && v0.uv.y == v2.uv.y;
+		if (tri.isFlat)
+		{
+			// Solid fills sample the white pixel of the atlas, shade them once
+			tri.flatColor = modulate(vertexColor(v0.col), sampleBilinear(texture, tri.uv[0].x, tri.uv[0].y));
+			if ((tri.flatColor >> 24) == 0)
+			{
+				return;
+			}
+		}
+
+		addPrimitive(tri);
+	}
+
+	//--------------------------------------------------------------
+	bool SoftwareRasterizer::setupRectangle(const ImDrawVert * vtx_buffer, const ImDrawIdx * idx, const int clip[4], const Texture * texture, const ImVec2& offset, const ImVec2& scale)
+	{
+		// ImDrawList::PrimRect() and PrimRectUV() emit a, b, c and a, c, d with the corners in order,
+		// covering the rectangle. Filled like this, the pixels along the diagonal need no edge tests.
+		if (idx[3] != idx[0] || idx[4] != idx[2])
+		{
+			return false;
+		}
+		const ImDrawVert& a = vtx_buffer[idx[0]];
+		const ImDrawVert& b = vtx_buffer[idx[1]];
+		const ImDrawVert& c = vtx_buffer[idx[2]];
+		const ImDrawVert& d = vtx_buffer[idx[5]];
+		if (a.pos.y != b.pos.y || b.pos.x != c.pos.x || c.pos.y != d.pos.y || d.pos.x != a.pos.x
+			|| a.uv.y != b.uv.y || b.uv.x != c.uv.x || c.uv.y != d.uv.y || d.uv.x != a.uv.x
+			|| a.col != b.col || a.col != c.col || a.col != d.col)
+		{
+			return false;
+		}
+
+		ImVec2 pos_a((a.pos.x - offset.x) * scale.x, (a.pos.y - offset.y) * scale.y);
+		ImVec2 pos_c((c.pos.x - offset.x) * scale.x, (c.pos.y - offset.y) * scale.y);
+		if (pos_a.x == pos_c.x || pos_a.y == pos_c.y || std::isnan(pos_a.x + pos_a.y + pos_c.x + pos_c.y))
+		{
+			return true;
+		}
+
+		// Pixel centers on the top and left edges are inside, like with the two triangles
+		Primitive rect;
+		rect.isRect = true;
+		rect.minX = std::max(ceilToInt(std::min(std::max(std::min(pos_a.x, pos_c.x) - 0.5f, -1.0f), (float)clip[2])), clip[0]);
+		rect.maxX = std::min(ceilToInt(std::min(std::max(std::max(pos_a.x, pos_c.x) - 0.5f, -1.0f), (float)clip[2])), clip[2]);
+		rect.minY = std::max(ceilToInt(std::min(std::max(std::min(pos_a.y, pos_c.y) - 0.5f, -1.0f), (float)clip[3])), clip[1]);
+		rect.maxY = std::min(ceilToInt(std::min(std::max(std::max(pos_a.y, pos_c.y) - 0.5f, -1.0f), (float)clip[3])), clip[3]);
+		if (rect.minX >= rect.maxX || rect.minY >= rect.maxY)
+		{
+			return true;
+		}
+
+		rect.originX[0] = pos_a.x;
+		rect.originY[0] = pos_a.y;
+		rect.uv[0] = a.uv;
+		rect.uvStep = ImVec2((c.uv.x - a.uv.x) / (pos_c.x - pos_a.x), (c.uv.y - a.uv.y) / (pos_c.y - pos_a.y));
+		rect.texture = texture;
+		rect.rectColor = vertexColor(a.col);
+		rect.flatColor = 0;
+		rect.isFlat = a.uv.x == c.uv.x && a.uv.y == c.uv.y;
+		if (rect.isFlat)
+		{
+			rect.flatColor = modulate(rect.rectColor, sampleBilinear(texture, a.uv.x, a.uv.y));
+			if ((rect.flatColor >> 24) == 0)
+			{
+				return true;
+			}
+		}
+
+		// Glyphs drawn at their size map pixels to texels one to one, which skips filtering
+		rect.isTexelAligned = false;
+		if (!rect.isFlat && texture && !texture->texels.empty())
+		{
+			float texel_x = a.uv.x * texture->width - pos_a.x;
+			float texel_y = a.uv.y * texture->height - pos_a.y;
+			int offset_x = (int)std::round(texel_x);
+			int offset_y = (int)std::round(texel_y);
+			rect.isTexelAligned = std::fabs(rect.uvStep.x * texture->width - 1.0f) < 1e-4f && std::fabs(rect.uvStep.y * texture->height - 1.0f) < 1e-4f
+				&& std::fabs(texel_x - offset_x) < 1e-3f && std::fabs(texel_y - offset_y) < 1e-3f
+				&& rect.minX + offset_x >= 0 && rect.maxX + offset_x <= texture->width
+				&& rect.minY + offset_y >= 0 && rect.maxY + offset_y <= texture->height;
+			rect.texelOffsetX = offset_x;
+			rect.texelOffsetY = offset_y;
+		}
+
+		addPrimitive(rect);
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::addPrimitive(const Primitive& prim)
+	{
+		uint32_t index = (uint32_t)primitives.size();
+		primitives.push_back(prim);
+
+		int tile_x0 = prim.minX / kTileSize;
+		int tile_x1 = (prim.maxX - 1) / kTileSize;
+		int tile_y0 = prim.minY / kTileSize;
+		int tile_y1 = (prim.maxY - 1) / kTileSize;
+		for (int ty = tile_y0; ty <= tile_y1; ty++)
+		{
+			for (int tx = tile_x0; tx <= tile_x1; tx++)
+			{
+				tileBins[ty * tilesX + tx].push_back(index);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::renderTile(int tile)
+	{
+		const std::vector<uint32_t>& bin = tileBins[tile];
+		if (bin.empty())
+		{
+			return;
+		}
+		int tile_x0 = (tile % tilesX) * kTileSize;
+		int tile_y0 = (tile / tilesX) * kTileSize;
+		int tile_x1 = std::min(tile_x0 + kTileSize, targetWidth);
+		int tile_y1 = std::min(tile_y0 + kTileSize, targetHeight);
+
+		for (uint32_t index : bin)
+		{
+			const Primitive& prim = primitives[index];
+			int x0 = std::max(prim.minX, tile_x0);
+			int y0 = std::max(prim.minY, tile_y0);
+			int x1 = std::min(prim.maxX, tile_x1);
+			int y1 = std::min(prim.maxY, tile_y1);
+			if (prim.isRect)
+			{
+				drawRectangle(prim, x0, y0, x1, y1);
+			}
+			else
+			{
+				drawTriangle(prim, x0, y0, x1, y1);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::drawTriangle(const Primitive& tri, int x0, int y0, int x1, int y1)
+	{
+		if (x0 >= x1 || y0 >= y1)
+		{
+			return;
+		}
+
+		// Test the edges against the corner pixels of the rectangle first. Most tiles of the large
+		// window and frame rectangles are either missed or covered whole, which skips the edge tests.
+		bool is_covered = true;
+		for (int i = 0; i < 3; i++)
+		{
+			float a = tri.edgeA[i];
+			float b = tri.edgeB[i];
+			float near_x = (a >= 0.0f ? (float)x0 + 0.5f : (float)x1 - 0.5f) - tri.originX[i];
+			float far_x = (a >= 0.0f ? (float)x1 - 0.5f : (float)x0 + 0.5f) - tri.originX[i];
+			float near_y = (b >= 0.0f ? (float)y0 + 0.5f : (float)y1 - 0.5f) - tri.originY[i];
+			float far_y = (b >= 0.0f ? (float)y1 - 0.5f : (float)y0 + 0.5f) - tri.originY[i];
+			// Pixels this close to the edge are left to the exact test, interpolating rounds differently
+			float margin = kCoverageMargin * (std::fabs(a) + std::fabs(b));
+			if (a * far_x + b * far_y < -margin)
+			{
+				return;
+			}
+			is_covered = is_covered && a * near_x + b * near_y > margin;
+		}
+
+		if (is_covered && tri.isFlat)
+		{
+			fillSpans(tri.flatColor, x0, y0, x1, y1);
+			return;
+		}
+
+		Float4 origin_x[3] = { Float4(tri.originX[0]), Float4(tri.originX[1]), Float4(tri.originX[2]) };
+		Float4 edge_a[3] = { Float4(tri.edgeA[0]), Float4(tri.edgeA[1]), Float4(tri.edgeA[2]) };
+		float margins[3];
+		for (int i = 0; i < 3; i++)
+		{
+			margins[i] = kCoverageMargin * (std::fabs(tri.edgeA[i]) + std::fabs(tri.edgeB[i]));
+		}
+#if defined(OFXIMGUI_RASTERIZER_SSE2)
+		__m128i flat_terms = blendTerms(tri.flatColor, premultipliedAlpha);
+		__m128i flat_inv_alpha = _mm_set1_epi16((short)(255 - (tri.flatColor >> 24)));
+#endif
+
+		for (int y = y0; y < y1; y++)
+		{
+			uint32_t* row = (uint32_t*)target + (size_t)y * targetWidth;
+			float py = (float)y + 0.5f;
+			float by[3] = {
+				tri.edgeB[0] * (py - tri.originY[0]),
+				tri.edgeB[1] * (py - tri.originY[1]),
+				tri.edgeB[2] * (py - tri.originY[2])
+			};
+
+			// Solve the edges for the pixel centers this row may touch, and those it covers for sure.
+			// Both are rounded outwards by a pixel, the per lane tests stay exact.
+			float out_x0 = (float)x0 - 1.0f, out_x1 = (float)x1 + 1.0f;
+			float in_x0 = out_x0, in_x1 = out_x1;
+			for (int i = 0; i < 3; i++)
+			{
+				float a = tri.edgeA[i];
+				if (a > 0.0f)
+				{
+					out_x0 = std::max(out_x0, tri.originX[i] + (-margins[i] - by[i]) * tri.invEdgeA[i]);
+					in_x0 = std::max(in_x0, tri.originX[i] + (margins[i] - by[i]) * tri.invEdgeA[i]);
+				}
+				else if (a < 0.0f)
+				{
+					out_x1 = std::min(out_x1, tri.originX[i] + (-margins[i] - by[i]) * tri.invEdgeA[i]);
+					in_x1 = std::min(in_x1, tri.originX[i] + (margins[i] - by[i]) * tri.invEdgeA[i]);
+				}
+				else if (by[i] <= margins[i])
+				{
+					in_x1 = in_x0;
+					if (by[i] < -margins[i]) out_x1 = out_x0;
+				}
+			}
+			int row_x0 = std::max(x0, floorToInt(std::min(out_x0, (float)x1)) - 1);
+			int row_x1 = std::min(x1, ceilToInt(std::max(out_x1, (float)x0)) + 1);
+			int full_x0 = std::max(row_x0, ceilToInt(std::min(in_x0, (float)x1)) + 1);
+			int full_x1 = std::min(row_x1, floorToInt(std::max(in_x1, (float)x0)) - 1);
+			if (row_x0 >= row_x1)
+			{
+				continue;
+			}
+
+			Float4 edge_by[3] = { Float4(by[0]), Float4(by[1]), Float4(by[2]) };
+			for (int x = row_x0 & ~3; x < row_x1; x += 4)
+			{
+				bool is_full = x >= full_x0 && x + 4 <= full_x1;
+#if defined(OFXIMGUI_RASTERIZER_SSE2)
+				if (is_full && tri.isFlat)
+				{
+					if ((tri.flatColor >> 24) == 255)
+					{
+						_mm_storeu_si128((__m128i*)&row[x], _mm_set1_epi32((int)tri.flatColor));
+					}
+					else
+					{
+						blendPixels4(&row[x], flat_terms, flat_inv_alpha);
+					}
+					continue;
+				}
+#endif
+
+				Float4 px = Float4::ramp((float)x + 0.5f);
+				Float4 w0 = edge_a[0] * (px - origin_x[0]) + edge_by[0];
+				Float4 w1 = edge_a[1] * (px - origin_x[1]) + edge_by[1];
+				Float4 w2 = edge_a[2] * (px - origin_x[2]) + edge_by[2];
+				int mask = is_full ? 0xF : edgeMask(w0, tri.isTopLeft[0]) & edgeMask(w1, tri.isTopLeft[1]) & edgeMask(w2, tri.isTopLeft[2]);
+
+				// Lanes outside the span of this tile and clip rectangle
+				if (x < row_x0) mask &= 0xF << (row_x0 - x);
+				if (x + 4 > row_x1) mask &= 0xF >> (x + 4 - row_x1);
+				if (!mask)
+				{
+					continue;
+				}
+
+				if (tri.isFlat)
+				{
+					for (int lane = 0; lane < 4; lane++)
+					{
+						if (mask & (1 << lane)) blendPixel(row[x + lane], tri.flatColor, premultipliedAlpha);
+					}
+					continue;
+				}
+
+				float b1[4], b2[4];
+				(w1 * Float4(tri.invArea)).store(b1);
+				(w2 * Float4(tri.invArea)).store(b2);
+				for (int lane = 0; lane < 4; lane++)
+				{
+					if (!(mask & (1 << lane)))
+					{
+						continue;
+					}
+					float u = tri.uv[0].x + b1[lane] * (tri.uv[1].x - tri.uv[0].x) + b2[lane] * (tri.uv[2].x - tri.uv[0].x);
+					float v = tri.uv[0].y + b1[lane] * (tri.uv[1].y - tri.uv[0].y) + b2[lane] * (tri.uv[2].y - tri.uv[0].y);
+					uint32_t texel = sampleBilinear(tri.texture, u, v);
+					uint32_t rgba[4];
+					for (int c = 0; c < 4; c++)
+					{
+						float col = tri.color[0][c] + b1[lane] * (tri.color[1][c] - tri.color[0][c]) + b2[lane] * (tri.color[2][c] - tri.color[0][c]);
+						rgba[c] = div255(toByte(col) * ((texel >> (c * 8)) & 0xFF));
+					}
+					blendPixel(row[x + lane], packColor(rgba[0], rgba[1], rgba[2], rgba[3]), premultipliedAlpha);
+				}
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::drawRectangle(const Primitive& rect, int x0, int y0, int x1, int y1)
+	{
+		if (rect.isFlat)
+		{
+			fillSpans(rect.flatColor, x0, y0, x1, y1);
+			return;
+		}
+
+		for (int y = y0; y < y1; y++)
+		{
+			uint32_t* row = (uint32_t*)target + (size_t)y * targetWidth;
+			if (rect.isTexelAligned)
+			{
+				const uint32_t* texels = &rect.texture->texels[(size_t)(y + rect.texelOffsetY) * rect.texture->width + rect.texelOffsetX];
+				for (int x = x0; x < x1; x++)
+				{
+					// Mostly empty space around the glyphs
+					uint32_t texel = texels[x];
+					if (texel >> 24)
+					{
+						blendPixel(row[x], modulate(rect.rectColor, texel), premultipliedAlpha);
+					}
+				}
+				continue;
+			}
+
+			float v = rect.uv[0].y + ((float)y + 0.5f - rect.originY[0]) * rect.uvStep.y;
+			for (int x = x0; x < x1; x++)
+			{
+				float u = rect.uv[0].x + ((float)x + 0.5f - rect.originX[0]) * rect.uvStep.x;
+				blendPixel(row[x], modulate(rect.rectColor, sampleBilinear(rect.texture, u, v)), premultipliedAlpha);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::fillSpans(uint32_t color, int x0, int y0, int x1, int y1)
+	{
+		uint32_t a = color >> 24;
+#if defined(OFXIMGUI_RASTERIZER_SSE2)
+		__m128i color4 = _mm_set1_epi32((int)color);
+		__m128i terms = blendTerms(color, premultipliedAlpha);
+		__m128i inv_alpha = _mm_set1_epi16((short)(255 - a));
+#endif
+
+		for (int y = y0; y < y1; y++)
+		{
+			uint32_t* row = (uint32_t*)target + (size_t)y * targetWidth;
+			int x = x0;
+#if defined(OFXIMGUI_RASTERIZER_SSE2)
+			for (; x + 4 <= x1; x += 4)
+			{
+				if (a == 255)
+				{
+					_mm_storeu_si128((__m128i*)&row[x], color4);
+				}
+				else
+				{
+					blendPixels4(&row[x], terms, inv_alpha);
+				}
+			}
+#endif
+			for (; x < x1; x++)
+			{
+				blendPixel(row[x], color, premultipliedAlpha);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::runTiles()
+	{
+		int num_tiles = tilesX * tilesY;
+		for (;;)
+		{
+			int tile = nextTile++;
+			if (tile >= num_tiles)
+			{
+				break;
+			}
+			renderTile(tile);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::startWorkers()
+	{
+		int count = threadCount > 0 ? threadCount : (int)std::thread::hardware_concurrency();
+		isQuitting = false;
+		for (int i = 1; i < count; i++)
+		{
+			// Started from the rendering thread, so the generation cannot move before the worker reads it
+			workers.emplace_back(&SoftwareRasterizer::workerLoop, this, generation);
+		}
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::stopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isQuitting = true;
+		}
+		startCondition.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+		workers.clear();
+	}
+
+	//--------------------------------------------------------------
+	void SoftwareRasterizer::workerLoop(uint64_t seen_generation)
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				startCondition.wait(lock, [this, seen_generation]() { return isQuitting || generation != seen_generation; });
+				if (isQuitting)
+				{
+					return;
+				}
+				seen_generation = generation;
+			}
+			runTiles();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--busyWorkers == 0)
+				{
+					doneCondition.notify_one();
+				}
+			}
+		}
+	}
+}
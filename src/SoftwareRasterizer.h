@@ -0,0 +1,102 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ofxImGui
+{
+	// Renders ImDrawData into an RGBA 8 bit buffer on the CPU. The target is split into tiles
+	// that worker threads fill independently, triangles are tested four pixels at a time.
+	// Vertices are interpolated with the same blending as the GL backends, textures are sampled
+	// bilinear with clamping. User callbacks are skipped.
+	class SoftwareRasterizer
+	{
+	public:
+		SoftwareRasterizer();
+		~SoftwareRasterizer();
+
+		// Threads rendering tiles, including the calling one. 0 uses all cores.
+		void setThreadCount(int count);
+
+		// Blend so the target ends up with premultiplied alpha, like BaseEngine::g_PremultipliedAlphaTarget
+		void setPremultipliedAlpha(bool enabled);
+
+		// RGBA 8 bit pixels, copied. Unknown textures sample as white.
+		void setTexture(ImTextureID textureId, const unsigned char * pixels, int width, int height);
+		void removeTexture(ImTextureID textureId);
+
+		// Draws over the contents of pixels, which holds width * height RGBA pixels. scale maps
+		// vertices and clip rectangles to pixels, like io.DisplayFramebufferScale.
+		void render(const ImDrawData * draw_data, unsigned char * pixels, int width, int height, const ImVec2& scale = ImVec2(1.0f, 1.0f));
+
+	private:
+		struct Texture
+		{
+			int width = 0;
+			int height = 0;
+			std::vector<uint32_t> texels;
+		};
+
+		// A triangle, or a rectangle ImGui emitted as two of them
+		struct Primitive
+		{
+			float originX[3], originY[3];   // edge i is evaluated from this vertex, the same one for both triangles sharing the edge
+			float edgeA[3], edgeB[3];       // w = A * (x - origin.x) + B * (y - origin.y), positive inside
+			bool isTopLeft[3];
+			float invEdgeA[3];              // 0 for horizontal edges
+			float invArea;
+			int minX, minY, maxX, maxY;     // pixels covered by bounds and clip rect, max exclusive
+			ImVec2 uv[3];
+			float color[3][4];
+			bool isFlat;                    // same color and uv on all vertices
+			uint32_t flatColor;             // color times texel of flat primitives
+			const Texture * texture;
+
+			bool isRect;                    // corner origin[0] has uv[0], uv changes by uvStep per pixel
+			ImVec2 uvStep;
+			uint32_t rectColor;
+			bool isTexelAligned;            // pixel x, y shows texel x + texelOffsetX, y + texelOffsetY
+			int texelOffsetX, texelOffsetY;
+		};
+
+		void setupTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2, const int clip[4], const Texture * texture, const ImVec2& offset, const ImVec2& scale);
+		bool setupRectangle(const ImDrawVert * vtx_buffer, const ImDrawIdx * idx, const int clip[4], const Texture * texture, const ImVec2& offset, const ImVec2& scale);
+		void addPrimitive(const Primitive& prim);
+		void renderTile(int tile);
+		void drawTriangle(const Primitive& tri, int x0, int y0, int x1, int y1);
+		void drawRectangle(const Primitive& rect, int x0, int y0, int x1, int y1);
+		void fillSpans(uint32_t color, int x0, int y0, int x1, int y1);
+		void startWorkers();
+		void stopWorkers();
+		void workerLoop(uint64_t seen_generation);
+		void runTiles();
+
+		std::unordered_map<ImTextureID, Texture> textures;
+		bool premultipliedAlpha;
+		int threadCount;
+
+		// Per frame, kept to avoid allocating
+		std::vector<Primitive> primitives;
+		std::vector<std::vector<uint32_t>> tileBins;
+		unsigned char * target;
+		int targetWidth;
+		int targetHeight;
+		int tilesX;
+		int tilesY;
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable startCondition;
+		std::condition_variable doneCondition;
+		uint64_t generation;
+		int busyWorkers;
+		bool isQuitting;
+		std::atomic<int> nextTile;
+	};
+}
@@ -0,0 +1,244 @@
+#include "Tracer.h"
+
+#include "ofFileUtils.h"
+#include "ofLog.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#if defined(TARGET_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* name;
+		uint64_t start;         // steady clock, in nanoseconds
+		uint64_t duration;
+	};
+
+	// Events of one thread, a ring that only its thread writes to and only writeFile() and clear() read from
+	struct ThreadBuffer
+	{
+		struct OpenEvent
+		{
+			const char* name;
+			uint64_t start;
+		};
+
+		ThreadBuffer(int id_)
+			: events(ofxImGui::Tracer::kBufferSize)
+			, head(0)
+			, tail(0)
+			, dropped(0)
+			, id(id_)
+		{}
+
+		std::vector<TraceEvent> events;
+		std::atomic<uint64_t> head;     // next event to write
+		std::atomic<uint64_t> tail;     // next event to read
+		std::atomic<uint64_t> dropped;
+		const int id;                   // tid of its events
+
+		// Only used by the thread
+		std::vector<OpenEvent> openEvents;
+		std::unordered_set<std::string> names;  // copies of the std::string names, never erased so they stay valid
+	};
+
+	std::atomic<bool> g_Enabled(false);
+
+	// Buffers outlive their threads, so events of threads that ended are still written
+	std::mutex g_BuffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> g_Buffers;
+	thread_local ThreadBuffer* t_Buffer = nullptr;
+
+	ThreadBuffer& getThreadBuffer()
+	{
+		if (!t_Buffer)
+		{
+			// Once per thread
+			std::lock_guard<std::mutex> lock(g_BuffersMutex);
+			g_Buffers.emplace_back(new ThreadBuffer((int)g_Buffers.size() + 1));
+			t_Buffer = g_Buffers.back().get();
+		}
+		return *t_Buffer;
+	}
+
+	int getProcessId()
+	{
+#if defined(TARGET_WIN32)
+		return _getpid();
+#else
+		return (int)getpid();
+#endif
+	}
+
+	uint64_t getNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Trace timestamps are in microseconds
+	void writeMicroseconds(std::ostream& out, uint64_t nanoseconds)
+	{
+		char text[32];
+		snprintf(text, sizeof(text), "%llu.%03u", (unsigned long long)(nanoseconds / 1000), (unsigned int)(nanoseconds % 1000));
+		out << text;
+	}
+
+	void writeString(std::ostream& out, const char* text)
+	{
+		out << '"';
+		for (const char* c = text; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				out << '\\' << *c;
+			}
+			else if ((unsigned char)*c < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)(unsigned char)*c);
+				out << escaped;
+			}
+			else
+			{
+				out << *c;
+			}
+		}
+		out << '"';
+	}
+}
+
+namespace ofxImGui
+{
+	//--------------------------------------------------------------
+	void Tracer::setEnabled(bool enabled)
+	{
+		g_Enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	//--------------------------------------------------------------
+	bool Tracer::isEnabled()
+	{
+		return g_Enabled.load(std::memory_order_relaxed);
+	}
+
+	//--------------------------------------------------------------
+	void Tracer::begin(const char* name)
+	{
+		if (!isEnabled())
+		{
+			return;
+		}
+		getThreadBuffer().openEvents.push_back({ name, getNanoseconds() });
+	}
+
+	//--------------------------------------------------------------
+	void Tracer::begin(const std::string& name)
+	{
+		if (!isEnabled())
+		{
+			return;
+		}
+		ThreadBuffer& buffer = getThreadBuffer();
+		auto it = buffer.names.find(name);
+		if (it == buffer.names.end())
+		{
+			it = buffer.names.insert(name).first;
+		}
+		buffer.openEvents.push_back({ it->c_str(), getNanoseconds() });
+	}
+
+	//--------------------------------------------------------------
+	void Tracer::end()
+	{
+		// Turning tracing on or off while events are open leaves them unbalanced, toggle between frames
+		if (!isEnabled() || !t_Buffer || t_Buffer->openEvents.empty())
+		{
+			return;
+		}
+		ThreadBuffer& buffer = *t_Buffer;
+		ThreadBuffer::OpenEvent open_event = buffer.openEvents.back();
+		buffer.openEvents.pop_back();
+
+		uint64_t head = buffer.head.load(std::memory_order_relaxed);
+		if (head - buffer.tail.load(std::memory_order_acquire) >= (uint64_t)kBufferSize)
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer.events[head % kBufferSize] = { open_event.name, open_event.start, getNanoseconds() - open_event.start };
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	//--------------------------------------------------------------
+	bool Tracer::writeFile(const std::string& path)
+	{
+		std::ofstream file(ofToDataPath(path), std::ios::binary);
+		if (!file)
+		{
+			ofLogError("ofxImGui") << "Could not open trace file " << path;
+			return false;
+		}
+
+		const int pid = getProcessId();
+		uint64_t dropped = 0;
+		file << "{\"traceEvents\":[";
+		{
+			std::lock_guard<std::mutex> lock(g_BuffersMutex);
+			bool isFirst = true;
+			for (auto& buffer : g_Buffers)
+			{
+				// Names the thread's track
+				file << (isFirst ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << buffer->id
+					<< ",\"args\":{\"name\":\"ofxImGui " << buffer->id << "\"}}";
+				isFirst = false;
+
+				uint64_t head = buffer->head.load(std::memory_order_acquire);
+				uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+				for (; tail != head; tail++)
+				{
+					const TraceEvent& event = buffer->events[tail % kBufferSize];
+					file << ",\n{\"ph\":\"X\",\"cat\":\"ofxImGui\",\"name\":";
+					writeString(file, event.name);
+					file << ",\"pid\":" << pid << ",\"tid\":" << buffer->id << ",\"ts\":";
+					writeMicroseconds(file, event.start);
+					file << ",\"dur\":";
+					writeMicroseconds(file, event.duration);
+					file << "}";
+				}
+				buffer->tail.store(head, std::memory_order_release);
+				dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+			}
+		}
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+		if (dropped > 0)
+		{
+			ofLogWarning("ofxImGui") << "Dropped " << dropped << " trace events, write the trace more often";
+		}
+		return (bool)file;
+	}
+
+	//--------------------------------------------------------------
+	void Tracer::clear()
+	{
+		std::lock_guard<std::mutex> lock(g_BuffersMutex);
+		for (auto& buffer : g_Buffers)
+		{
+			buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+			buffer->dropped.store(0, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+namespace ofxImGui
+{
+	// Records the phases of the GUI frames as Chrome trace events, for chrome://tracing and Perfetto:
+	// NewFrame, Render, the engine's draw, and the windows of ofxImGui::BeginWindow() and EndWindow().
+	// Each thread records into its own buffer without locking, writeFile() collects them. Timestamps
+	// come from std::chrono::steady_clock, the clock most tracers use, so the events line up with
+	// traces of the rest of the app.
+	class Tracer
+	{
+	public:
+		static const int kBufferSize = 1 << 15;     // events kept per thread until writeFile(), further ones are dropped
+
+		static void setEnabled(bool enabled);
+		static bool isEnabled();
+
+		// Opens an event on the calling thread, it is recorded when end() closes it. Events nest and are
+		// closed in reverse order. name must stay valid until the event is written, like a literal.
+		static void begin(const char* name);
+
+		// Same, for names that do not stay valid. The name is copied the first time it is seen.
+		static void begin(const std::string& name);
+
+		static void end();
+
+		// Writes the events recorded so far on all threads to a JSON file, relative to the data folder,
+		// and removes them from the buffers. Events still open go to the file written after they close.
+		static bool writeFile(const std::string& path);
+
+		// Drops the events recorded so far
+		static void clear();
+	};
+}
@@ -73,7 +73,9 @@ ImVec4(const ofFloatColor& f) { x = f.r; y = f.g; z = f.b; w = f.a; }
 operator ofFloatColor() const { return ofFloatColor(x, y, z, w); }
 #endif
 
-#define ImDrawIdx ofIndexType
+//---- 16-bit indices on all targets. The engines set ImGuiBackendFlags_RendererHasVtxOffset,
+//---- so draw lists past 64K vertices are split in segments instead of needing 32-bit indices.
+//#define ImDrawIdx unsigned int
 
 //---- Freely implement extra functions within the ImGui:: namespace.
 //---- Declare helpers or widgets implemented in imgui_user.inl or elsewhere, so end-user doesn't need to include multiple files.
@@ -0,0 +1,383 @@
+#include "DrawDataStream.h"
+#include "Test.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace ofxImGui;
+
+namespace
+{
+	ImTextureID const kFontTexture = (ImTextureID)(intptr_t)0x10;
+	ImTextureID const kImageTexture = (ImTextureID)(intptr_t)0x20;
+	ImTextureID const kLocalFontTexture = (ImTextureID)(intptr_t)0x30;
+
+	// Draw data owning its lists, like the one ImGui::Render() hands out
+	struct Frame
+	{
+		std::vector<std::unique_ptr<ImDrawList>> lists;
+		ImVector<ImDrawList*> listPointers;
+		ImDrawData drawData;
+
+		ImDrawList* addList()
+		{
+			lists.emplace_back(new ImDrawList(nullptr));
+			return lists.back().get();
+		}
+
+		ImDrawData* finish()
+		{
+			listPointers.resize((int)lists.size());
+			drawData.Valid = true;
+			drawData.CmdLists = listPointers.Data;
+			drawData.CmdListsCount = (int)lists.size();
+			drawData.TotalVtxCount = drawData.TotalIdxCount = 0;
+			for (size_t n = 0; n < lists.size(); n++)
+			{
+				listPointers[(int)n] = lists[n].get();
+				drawData.TotalVtxCount += lists[n]->VtxBuffer.Size;
+				drawData.TotalIdxCount += lists[n]->IdxBuffer.Size;
+			}
+			drawData.DisplayPos = ImVec2(0.0f, 0.0f);
+			drawData.DisplaySize = ImVec2(640.0f, 480.0f);
+			drawData.FramebufferScale = ImVec2(1.0f, 1.0f);
+			return &drawData;
+		}
+	};
+
+	// Quads, one command per texture
+	void addQuads(ImDrawList* list, int num_quads, ImTextureID texture, float x, unsigned int vtx_offset = 0)
+	{
+		ImDrawCmd cmd;
+		cmd.ElemCount = (unsigned int)num_quads * 6;
+		cmd.ClipRect = ImVec4(0.0f, 0.0f, 640.0f, 480.0f);
+		cmd.TextureId = texture;
+		cmd.VtxOffset = vtx_offset;
+		list->CmdBuffer.push_back(cmd);
+
+		unsigned int first = (unsigned int)list->VtxBuffer.Size - vtx_offset;
+		for (int q = 0; q < num_quads; q++)
+		{
+			for (int v = 0; v < 4; v++)
+			{
+				ImDrawVert vert;
+				vert.pos = ImVec2(x + q * 10.0f + (v & 1) * 8.0f, (v >> 1) * 8.0f);
+				vert.uv = ImVec2((float)(v & 1), (float)(v >> 1));
+				vert.col = 0xFF000000 | (unsigned int)(q * 77 + v);
+				list->VtxBuffer.push_back(vert);
+			}
+			const unsigned int quad[6] = { 0, 1, 2, 1, 3, 2 };
+			for (unsigned int i : quad)
+			{
+				list->IdxBuffer.push_back((ImDrawIdx)(first + q * 4 + i));
+			}
+		}
+	}
+
+	// Same geometry and commands, textures mapped like the decoder does
+	bool isSameFrame(const ImDrawData* sent, const ImDrawData* received)
+	{
+		if (!received || received->CmdListsCount != sent->CmdListsCount
+			|| received->TotalVtxCount != sent->TotalVtxCount || received->TotalIdxCount != sent->TotalIdxCount
+			|| received->DisplaySize.x != sent->DisplaySize.x || received->DisplaySize.y != sent->DisplaySize.y)
+		{
+			return false;
+		}
+		for (int n = 0; n < sent->CmdListsCount; n++)
+		{
+			const ImDrawList* a = sent->CmdLists[n];
+			const ImDrawList* b = received->CmdLists[n];
+			if (a->CmdBuffer.Size != b->CmdBuffer.Size || a->VtxBuffer.Size != b->VtxBuffer.Size || a->IdxBuffer.Size != b->IdxBuffer.Size
+				|| memcmp(a->VtxBuffer.Data, b->VtxBuffer.Data, (size_t)a->VtxBuffer.Size * sizeof(ImDrawVert)) != 0
+				|| memcmp(a->IdxBuffer.Data, b->IdxBuffer.Data, (size_t)a->IdxBuffer.Size * sizeof(ImDrawIdx)) != 0)
+			{
+				return false;
+			}
+			for (int c = 0; c < a->CmdBuffer.Size; c++)
+			{
+				const ImDrawCmd& ca = a->CmdBuffer[c];
+				const ImDrawCmd& cb = b->CmdBuffer[c];
+				ImTextureID expected = ca.TextureId == kFontTexture ? kLocalFontTexture : nullptr;
+				if (ca.ElemCount != cb.ElemCount || ca.VtxOffset != cb.VtxOffset || cb.TextureId != expected
+					|| memcmp(&ca.ClipRect, &cb.ClipRect, sizeof(ImVec4)) != 0)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Every index of every command inside the vertices, what the decoder must guarantee
+	bool isInBounds(const ImDrawData* draw_data)
+	{
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+		{
+			const ImDrawList* list = draw_data->CmdLists[n];
+			size_t idx_offset = 0;
+			for (const ImDrawCmd& cmd : list->CmdBuffer)
+			{
+				if (idx_offset + cmd.ElemCount > (size_t)list->IdxBuffer.Size)
+				{
+					return false;
+				}
+				for (unsigned int i = 0; i < cmd.ElemCount; i++)
+				{
+					if ((size_t)cmd.VtxOffset + list->IdxBuffer[(int)(idx_offset + i)] >= (size_t)list->VtxBuffer.Size)
+					{
+						return false;
+					}
+				}
+				idx_offset += cmd.ElemCount;
+			}
+		}
+		return true;
+	}
+
+	std::vector<unsigned char> randomBytes(size_t size, int zero_percent)
+	{
+		std::vector<unsigned char> bytes(size);
+		for (unsigned char& byte : bytes)
+		{
+			byte = rand() % 100 < zero_percent ? 0 : (unsigned char)(rand() & 0xFF);
+		}
+		return bytes;
+	}
+
+	//--------------------------------------------------------------
+	void testDeltaRoundTrip()
+	{
+		const size_t sizes[] = { 0, 1, 3, 4, 5, 17, 256, 4099 };
+		for (size_t size : sizes)
+		{
+			for (size_t prev_size : sizes)
+			{
+				std::vector<unsigned char> prev = randomBytes(prev_size, 50);
+				std::vector<unsigned char> data = randomBytes(size, 50);
+
+				// Mostly unchanged, like consecutive frames
+				for (size_t i = 0; i < size && i < prev_size; i++)
+				{
+					if (rand() % 8 != 0)
+					{
+						data[i] = prev[i];
+					}
+				}
+
+				std::vector<unsigned char> encoded;
+				encodeDelta(data.data(), size, prev.data(), prev_size, encoded);
+
+				// Decoded over the previous bytes, in a buffer that grew or shrank like an ImVector
+				std::vector<unsigned char> decoded(prev);
+				decoded.resize(size, 0xCD);
+				size_t read = decodeDelta(encoded.data(), encoded.size(), decoded.data(), size, prev_size);
+				CHECK(read == encoded.size());
+				CHECK(decoded == data);
+			}
+		}
+
+		// Unchanged data costs next to nothing
+		std::vector<unsigned char> same = randomBytes(4096, 0);
+		std::vector<unsigned char> encoded;
+		encodeDelta(same.data(), same.size(), same.data(), same.size(), encoded);
+		CHECK(encoded.size() <= 4);
+	}
+
+	//--------------------------------------------------------------
+	void testDeltaCorruption()
+	{
+		std::vector<unsigned char> data = randomBytes(1000, 30);
+		std::vector<unsigned char> encoded;
+		encodeDelta(data.data(), data.size(), nullptr, 0, encoded);
+
+		// Truncated input
+		std::vector<unsigned char> decoded(data.size());
+		for (size_t size = 0; size < encoded.size(); size++)
+		{
+			CHECK(decodeDelta(encoded.data(), size, decoded.data(), decoded.size(), 0) == 0);
+		}
+
+		// Runs past the end of the data
+		CHECK(decodeDelta(encoded.data(), encoded.size(), decoded.data(), decoded.size() - 1, 0) == 0);
+		const unsigned char huge_run[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00 };
+		CHECK(decodeDelta(huge_run, sizeof(huge_run), decoded.data(), decoded.size(), 0) == 0);
+		const unsigned char endless_varint[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+		CHECK(decodeDelta(endless_varint, sizeof(endless_varint), decoded.data(), decoded.size(), 0) == 0);
+
+		// Random damage never reads or writes out of bounds, the sanitizers catch it when they are on
+		for (int round = 0; round < 2000; round++)
+		{
+			std::vector<unsigned char> damaged(encoded);
+			damaged[rand() % damaged.size()] ^= (unsigned char)(1 << (rand() % 8));
+			size_t read = decodeDelta(damaged.data(), damaged.size(), decoded.data(), decoded.size(), 0);
+			CHECK(read <= damaged.size());
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testStreamRoundTrip()
+	{
+		DrawDataEncoder encoder;
+		DrawDataDecoder decoder;
+		decoder.setFontTexture(kLocalFontTexture);
+		std::vector<unsigned char> message;
+
+		// Key frame
+		Frame first;
+		addQuads(first.addList(), 20, kFontTexture, 0.0f);
+		ImDrawList* images = first.addList();
+		addQuads(images, 3, kImageTexture, 100.0f);
+		addQuads(images, 5, kFontTexture, 200.0f);
+		encoder.encode(first.finish(), kFontTexture, message);
+		CHECK(decoder.decode(message.data(), message.size()));
+		CHECK(isSameFrame(first.finish(), decoder.getDrawData()));
+
+		// Same frame, lists are skipped
+		size_t key_frame_size = message.size();
+		message.clear();
+		encoder.encode(first.finish(), kFontTexture, message);
+		CHECK(message.size() < key_frame_size / 10);
+		CHECK(decoder.decode(message.data(), message.size()));
+		CHECK(isSameFrame(first.finish(), decoder.getDrawData()));
+
+		// Moved vertices, a list more, and a segment past 64K vertices using VtxOffset
+		Frame second;
+		addQuads(second.addList(), 20, kFontTexture, 5.0f);
+		ImDrawList* segments = second.addList();
+		addQuads(segments, 3, kImageTexture, 100.0f);
+		addQuads(segments, 2, kFontTexture, 300.0f, (unsigned int)segments->VtxBuffer.Size);
+		addQuads(second.addList(), 1, kFontTexture, 400.0f);
+		message.clear();
+		encoder.encode(second.finish(), kFontTexture, message);
+		CHECK(decoder.decode(message.data(), message.size()));
+		CHECK(isSameFrame(second.finish(), decoder.getDrawData()));
+
+		// Fewer lists
+		Frame third;
+		addQuads(third.addList(), 2, kFontTexture, 0.0f);
+		message.clear();
+		encoder.encode(third.finish(), kFontTexture, message);
+		CHECK(decoder.decode(message.data(), message.size()));
+		CHECK(isSameFrame(third.finish(), decoder.getDrawData()));
+
+		// A new viewer starts from a key frame
+		DrawDataDecoder late_decoder;
+		late_decoder.setFontTexture(kLocalFontTexture);
+		encoder.reset();
+		message.clear();
+		encoder.encode(second.finish(), kFontTexture, message);
+		CHECK(late_decoder.decode(message.data(), message.size()));
+		CHECK(isSameFrame(second.finish(), late_decoder.getDrawData()));
+	}
+
+	//--------------------------------------------------------------
+	std::vector<unsigned char> encodeKeyFrame(const ImDrawData* draw_data)
+	{
+		DrawDataEncoder encoder;
+		std::vector<unsigned char> message;
+		encoder.encode(draw_data, kFontTexture, message);
+		return message;
+	}
+
+	//--------------------------------------------------------------
+	void testStreamCorruption()
+	{
+		std::vector<unsigned char> message;
+
+		// Index past the vertices
+		Frame bad_index;
+		ImDrawList* list = bad_index.addList();
+		addQuads(list, 4, kFontTexture, 0.0f);
+		list->IdxBuffer[5] = (ImDrawIdx)list->VtxBuffer.Size;
+		message = encodeKeyFrame(bad_index.finish());
+		DrawDataDecoder decoder;
+		CHECK(!decoder.decode(message.data(), message.size()));
+		CHECK(decoder.getDrawData() == nullptr);
+
+		// VtxOffset moving valid indices past the vertices
+		Frame bad_offset;
+		list = bad_offset.addList();
+		addQuads(list, 4, kFontTexture, 0.0f);
+		list->CmdBuffer[0].VtxOffset = 1;
+		message = encodeKeyFrame(bad_offset.finish());
+		CHECK(!decoder.decode(message.data(), message.size()));
+
+		// More elements than indices
+		Frame bad_count;
+		list = bad_count.addList();
+		addQuads(list, 4, kFontTexture, 0.0f);
+		addQuads(list, 1, kImageTexture, 50.0f);
+		list->CmdBuffer[1].ElemCount += 3;
+		message = encodeKeyFrame(bad_count.finish());
+		CHECK(!decoder.decode(message.data(), message.size()));
+
+		// Valid again
+		Frame good;
+		addQuads(good.addList(), 4, kFontTexture, 0.0f);
+		message = encodeKeyFrame(good.finish());
+		CHECK(decoder.decode(message.data(), message.size()));
+
+		// Truncated frame, then the delta frames that follow are refused until the next key frame
+		DrawDataEncoder encoder;
+		std::vector<unsigned char> key_frame;
+		encoder.encode(good.finish(), kFontTexture, key_frame);
+		CHECK(!decoder.decode(key_frame.data(), key_frame.size() - 1));
+		std::vector<unsigned char> delta_frame;
+		encoder.encode(good.finish(), kFontTexture, delta_frame);
+		CHECK(!decoder.decode(delta_frame.data(), delta_frame.size()));
+		CHECK(decoder.decode(key_frame.data(), key_frame.size()));
+		CHECK(decoder.decode(delta_frame.data(), delta_frame.size()));
+
+		// Random damage is refused or decodes to lists the backends can draw
+		Frame big;
+		addQuads(big.addList(), 30, kFontTexture, 0.0f);
+		ImDrawList* mixed = big.addList();
+		addQuads(mixed, 10, kImageTexture, 100.0f);
+		addQuads(mixed, 10, kFontTexture, 200.0f, (unsigned int)mixed->VtxBuffer.Size);
+		key_frame = encodeKeyFrame(big.finish());
+		for (int round = 0; round < 2000; round++)
+		{
+			std::vector<unsigned char> damaged(key_frame);
+			for (int flips = 1 + rand() % 3; flips > 0; flips--)
+			{
+				damaged[rand() % damaged.size()] ^= (unsigned char)(1 << (rand() % 8));
+			}
+			DrawDataDecoder fuzzed;
+			if (fuzzed.decode(damaged.data(), damaged.size()))
+			{
+				CHECK(isInBounds(fuzzed.getDrawData()));
+			}
+		}
+	}
+
+	//--------------------------------------------------------------
+	void testSnapshotOwnerName()
+	{
+		// The window owning a list can be destroyed, and its name freed, before the snapshot is drawn
+		std::unique_ptr<char[]> name(new char[16]);
+		strcpy(name.get(), "Window");
+		Frame frame;
+		frame.addList()->_OwnerName = name.get();
+		frame.addList();
+		DrawDataSnapshot snapshot;
+		snapshot.copyFrom(frame.finish());
+		name.reset();
+
+		const ImDrawData* copy = snapshot.getDrawData();
+		CHECK(copy && strcmp(copy->CmdLists[0]->_OwnerName, "Window") == 0);
+		CHECK(copy && copy->CmdLists[1]->_OwnerName == nullptr);
+	}
+}
+
+int main()
+{
+	srand(1);
+	testDeltaRoundTrip();
+	testDeltaCorruption();
+	testStreamRoundTrip();
+	testStreamCorruption();
+	testSnapshotOwnerName();
+	return test::testResult("DrawDataStreamTest");
+}
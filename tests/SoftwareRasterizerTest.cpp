@@ -0,0 +1,201 @@
+#include "SoftwareRasterizer.h"
+#include "Test.h"
+
+#include "imgui_internal.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ofxImGui;
+
+namespace
+{
+	const int kWidth = 32;
+	const int kHeight = 32;
+	ImTextureID const kCheckerTexture = (ImTextureID)(intptr_t)0x10;
+
+	// One list drawn with the ImDrawList API, white texture pixel at uv 0, 0
+	struct Scene
+	{
+		ImDrawListSharedData sharedData;
+		ImDrawList list;
+		ImDrawList* listPointer;
+		ImDrawData drawData;
+
+		Scene()
+			: list(&sharedData)
+			, listPointer(&list)
+		{
+			sharedData.ClipRectFullscreen = ImVec4(0.0f, 0.0f, (float)kWidth, (float)kHeight);
+			list.PushClipRectFullScreen();
+			list.PushTextureID(nullptr);
+		}
+
+		ImDrawData* finish()
+		{
+			drawData.Valid = true;
+			drawData.CmdLists = &listPointer;
+			drawData.CmdListsCount = 1;
+			drawData.TotalVtxCount = list.VtxBuffer.Size;
+			drawData.TotalIdxCount = list.IdxBuffer.Size;
+			drawData.DisplayPos = ImVec2(0.0f, 0.0f);
+			drawData.DisplaySize = ImVec2((float)kWidth, (float)kHeight);
+			drawData.FramebufferScale = ImVec2(1.0f, 1.0f);
+			return &drawData;
+		}
+	};
+
+	// Opaque red, half transparent blue partly over it, green clipped to its left half,
+	// a 2x2 checker texture drawn texel for texel, and a triangle
+	ImDrawData* buildScene(Scene& scene)
+	{
+		ImDrawList& list = scene.list;
+		list.AddRectFilled(ImVec2(4.0f, 4.0f), ImVec2(12.0f, 12.0f), IM_COL32(255, 0, 0, 255));
+		list.AddRectFilled(ImVec2(8.0f, 8.0f), ImVec2(16.0f, 16.0f), IM_COL32(0, 0, 255, 128));
+
+		list.PushClipRect(ImVec2(20.0f, 0.0f), ImVec2(24.0f, 8.0f));
+		list.AddRectFilled(ImVec2(20.0f, 0.0f), ImVec2(28.0f, 8.0f), IM_COL32(0, 255, 0, 255));
+		list.PopClipRect();
+
+		list.PushTextureID(kCheckerTexture);
+		list.AddImage(kCheckerTexture, ImVec2(0.0f, 20.0f), ImVec2(2.0f, 22.0f));
+		list.PopTextureID();
+
+		list.AddTriangleFilled(ImVec2(0.0f, 24.0f), ImVec2(8.0f, 24.0f), ImVec2(0.0f, 32.0f), IM_COL32(255, 255, 255, 255));
+		return scene.finish();
+	}
+
+	void setCheckerTexture(SoftwareRasterizer& rasterizer)
+	{
+		const unsigned char texels[2 * 2 * 4] = {
+			255, 255, 0, 255,   0, 255, 255, 255,
+			255, 0, 255, 255,   0, 0, 0, 255,
+		};
+		rasterizer.setTexture(kCheckerTexture, texels, 2, 2);
+	}
+
+	std::vector<unsigned char> render(SoftwareRasterizer& rasterizer, const ImDrawData* draw_data, int width, int height, const ImVec2& scale)
+	{
+		std::vector<unsigned char> pixels((size_t)width * height * 4, 0);
+		rasterizer.render(draw_data, pixels.data(), width, height, scale);
+		return pixels;
+	}
+
+	// Blending rounds, channels may be one step off
+	bool isPixel(const std::vector<unsigned char>& pixels, int width, int x, int y, int r, int g, int b, int a)
+	{
+		const unsigned char* p = &pixels[((size_t)y * width + x) * 4];
+		int expected[4] = { r, g, b, a };
+		for (int c = 0; c < 4; c++)
+		{
+			if (abs(p[c] - expected[c]) > 1)
+			{
+				printf("pixel %d, %d is %d %d %d %d, expected %d %d %d %d\n", x, y, p[0], p[1], p[2], p[3], r, g, b, a);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void testScene()
+	{
+		Scene scene;
+		ImDrawData* draw_data = buildScene(scene);
+		SoftwareRasterizer rasterizer;
+		rasterizer.setThreadCount(1);
+		setCheckerTexture(rasterizer);
+		std::vector<unsigned char> pixels = render(rasterizer, draw_data, kWidth, kHeight, ImVec2(1.0f, 1.0f));
+
+		// Rectangles cover the pixels from their min up to, not including, their max
+		CHECK(isPixel(pixels, kWidth, 3, 3, 0, 0, 0, 0));
+		CHECK(isPixel(pixels, kWidth, 4, 4, 255, 0, 0, 255));
+		CHECK(isPixel(pixels, kWidth, 7, 7, 255, 0, 0, 255));
+		CHECK(isPixel(pixels, kWidth, 16, 16, 0, 0, 0, 0));
+
+		// Straight alpha blending, like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+		CHECK(isPixel(pixels, kWidth, 10, 10, 127, 0, 128, 191));
+		CHECK(isPixel(pixels, kWidth, 14, 14, 0, 0, 128, 64));
+
+		CHECK(isPixel(pixels, kWidth, 21, 4, 0, 255, 0, 255));
+		CHECK(isPixel(pixels, kWidth, 25, 4, 0, 0, 0, 0));
+
+		CHECK(isPixel(pixels, kWidth, 0, 20, 255, 255, 0, 255));
+		CHECK(isPixel(pixels, kWidth, 1, 20, 0, 255, 255, 255));
+		CHECK(isPixel(pixels, kWidth, 0, 21, 255, 0, 255, 255));
+		CHECK(isPixel(pixels, kWidth, 1, 21, 0, 0, 0, 255));
+
+		CHECK(isPixel(pixels, kWidth, 1, 25, 255, 255, 255, 255));
+		CHECK(isPixel(pixels, kWidth, 6, 30, 0, 0, 0, 0));
+	}
+
+	void testPremultipliedAlpha()
+	{
+		Scene scene;
+		ImDrawData* draw_data = buildScene(scene);
+		SoftwareRasterizer rasterizer;
+		rasterizer.setThreadCount(1);
+		rasterizer.setPremultipliedAlpha(true);
+		std::vector<unsigned char> pixels = render(rasterizer, draw_data, kWidth, kHeight, ImVec2(1.0f, 1.0f));
+
+		// Alpha adds up with GL_ONE as source factor
+		CHECK(isPixel(pixels, kWidth, 10, 10, 127, 0, 128, 255));
+		CHECK(isPixel(pixels, kWidth, 14, 14, 0, 0, 128, 128));
+	}
+
+	void testScale()
+	{
+		Scene scene;
+		ImDrawData* draw_data = buildScene(scene);
+		SoftwareRasterizer rasterizer;
+		rasterizer.setThreadCount(1);
+		std::vector<unsigned char> pixels = render(rasterizer, draw_data, kWidth * 2, kHeight * 2, ImVec2(2.0f, 2.0f));
+
+		CHECK(isPixel(pixels, kWidth * 2, 7, 7, 0, 0, 0, 0));
+		CHECK(isPixel(pixels, kWidth * 2, 8, 8, 255, 0, 0, 255));
+		CHECK(isPixel(pixels, kWidth * 2, 15, 15, 255, 0, 0, 255));
+		CHECK(isPixel(pixels, kWidth * 2, 16, 16, 127, 0, 128, 191));
+
+		// The clip rectangle scales with the geometry
+		CHECK(isPixel(pixels, kWidth * 2, 47, 8, 0, 255, 0, 255));
+		CHECK(isPixel(pixels, kWidth * 2, 48, 8, 0, 0, 0, 0));
+	}
+
+	// Tiles rendered by other threads give the same image, larger than a tile so there are several
+	void testThreads()
+	{
+		const int width = 200;
+		const int height = 150;
+		Scene scene;
+		scene.sharedData.ClipRectFullscreen = ImVec4(0.0f, 0.0f, (float)width, (float)height);
+		scene.list.PopClipRect();
+		scene.list.PushClipRectFullScreen();
+		for (int i = 0; i < 40; i++)
+		{
+			float x = (float)((i * 37) % (width - 20));
+			float y = (float)((i * 23) % (height - 20));
+			scene.list.AddRectFilled(ImVec2(x, y), ImVec2(x + 30.5f, y + 20.25f), IM_COL32(i * 6, 255 - i * 6, 128, 100 + i * 3), 4.0f);
+			scene.list.AddTriangleFilled(ImVec2(x, y), ImVec2(x + 40.0f, y + 10.0f), ImVec2(x + 10.0f, y + 35.0f), IM_COL32(255, i * 6, 0, 200));
+		}
+		ImDrawData* draw_data = scene.finish();
+		draw_data->DisplaySize = ImVec2((float)width, (float)height);
+
+		SoftwareRasterizer single;
+		single.setThreadCount(1);
+		SoftwareRasterizer threaded;
+		threaded.setThreadCount(4);
+		std::vector<unsigned char> expected = render(single, draw_data, width, height, ImVec2(1.0f, 1.0f));
+		for (int frame = 0; frame < 3; frame++)
+		{
+			CHECK(render(threaded, draw_data, width, height, ImVec2(1.0f, 1.0f)) == expected);
+		}
+	}
+}
+
+int main()
+{
+	testScene();
+	testPremultipliedAlpha();
+	testScale();
+	testThreads();
+	return test::testResult("SoftwareRasterizerTest");
+}
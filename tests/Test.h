@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+// Checks for the tests, a failed one is printed and counted, main() returns testResult()
+namespace test
+{
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline int testResult(const char* name)
+	{
+		printf("%s: %s\n", name, failures() == 0 ? "passed" : "FAILED");
+		return failures() == 0 ? 0 : 1;
+	}
+}
+
+#define CHECK(expr) \
+	do \
+	{ \
+		if (!(expr)) \
+		{ \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			test::failures()++; \
+		} \
+	} while (0)
@@ -0,0 +1,4 @@
+#pragma once
+
+// Plain ImGui configuration for the tests, which build without openFrameworks.
+// Takes the place of src/imconfig.h, keep the options that change the ImGui types in sync.